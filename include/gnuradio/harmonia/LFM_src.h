@@ -47,6 +47,14 @@ public:
                               const std::string& sample_rate_key,
                               const std::string& label_key,
                               const std::string& prf_key) = 0;
+
+  /**
+   * @brief Attach the matched filter spectrum (mf_spectrum, mf_nfft,
+   * mf_length) to every published PDU so correlators can skip building it
+   *
+   * @param enable
+   */
+  virtual void set_mf_spectrum(bool enable) = 0;
 };
 
 } // namespace harmonia
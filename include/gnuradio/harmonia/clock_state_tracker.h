@@ -0,0 +1,60 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_HARMONIA_CLOCK_STATE_TRACKER_H
+#define INCLUDED_HARMONIA_CLOCK_STATE_TRACKER_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/harmonia/api.h>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    /*!
+     * \brief Track per-platform clock state [bias, drift, phase] across
+     * synchronization epochs with a Kalman filter
+     * \ingroup harmonia
+     *
+     * Estimates from clock_drift_est (sdr<k>) and clockbias_phase_est
+     * (cb_sdr<k>, cp_tx_sdr<k>) arriving on "in" are folded into the state
+     * as incremental updates. A message on "predict" publishes the state
+     * propagated to the requested epoch_time (or the current time) without
+     * updating it, so full sync epochs can be run less often.
+     */
+    class HARMONIA_API clock_state_tracker : virtual public gr::block
+    {
+    public:
+      typedef std::shared_ptr<clock_state_tracker> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of harmonia::clock_state_tracker.
+       *
+       * \param num_platforms Number of platforms tracked
+       * \param center_freq Carrier frequency (Hz), couples drift into phase
+       * \param q_bias Bias process noise (s^2 / s)
+       * \param q_drift Drift process noise (1 / s)
+       * \param q_phase Phase process noise (rad^2 / s)
+       * \param r_bias Bias measurement variance (s^2)
+       * \param r_drift Drift measurement variance
+       * \param r_phase Phase measurement variance (rad^2)
+       */
+      static sptr make(int num_platforms, double center_freq,
+                       double q_bias, double q_drift, double q_phase,
+                       double r_bias, double r_drift, double r_phase);
+
+      /*!
+       * \brief Clear all state and covariance back to the initial prior
+       */
+      virtual void reset() = 0;
+    };
+
+  } // namespace harmonia
+} // namespace gr
+
+#endif /* INCLUDED_HARMONIA_CLOCK_STATE_TRACKER_H */
@@ -10,6 +10,7 @@
 
 #include <gnuradio/block.h>
 #include <gnuradio/harmonia/api.h>
+#include <string>
 
 namespace gr
 {
@@ -37,6 +38,13 @@ namespace gr
        */
       static sptr make(int num_platforms, double center_freq, double samp_rate, double pulse_width,
                        double SNR, bool bias_status, bool phase_status);
+
+      /*!
+       * \brief Select a robust (IRLS) estimator for the link solve:
+       * "none" (plain WLS), "huber" or "tukey", with its tuning constant
+       * in units of the residual scale (e.g. 1.345 Huber, 4.685 Tukey).
+       */
+      virtual void set_robust_estimator(const std::string &kind, double tuning) = 0;
     };
 
   } // namespace harmonia
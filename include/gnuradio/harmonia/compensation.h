@@ -10,6 +10,7 @@
 
 #include <gnuradio/block.h>
 #include <gnuradio/harmonia/api.h>
+#include <string>
 
 namespace gr {
 namespace harmonia {
@@ -32,6 +33,13 @@ public:
    * creating new instances.
    */
   static sptr make(double center_freq, double samp_rate, int sdr_id);
+
+  /*!
+   * \brief Select how the fractional delay is applied: "fft" (exact,
+   * circular, two capture-length FFTs) or "fir" (polyphase windowed-sinc
+   * filter of the given number of taps, O(N * taps)).
+   */
+  virtual void set_delay_method(const std::string &method, int taps) = 0;
 };
 
 } // namespace harmonia
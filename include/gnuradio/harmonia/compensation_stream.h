@@ -0,0 +1,58 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_HARMONIA_COMPENSATION_STREAM_H
+#define INCLUDED_HARMONIA_COMPENSATION_STREAM_H
+
+#include <gnuradio/harmonia/api.h>
+#include <gnuradio/sync_block.h>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    /*!
+     * \brief Streaming version of compensation for continuous reception
+     * \ingroup harmonia
+     *
+     * Applies the clock drift (sdr<k> on cd_in), clock bias (cb_sdr<k> on
+     * cb_in) and carrier phase (cp_rx_sdr<k> on cp_in) corrections of
+     * platform sdr_id to a continuous complex stream. The drift phase is
+     * accumulated across work calls, and new estimates take effect together
+     * at the start of the next work call. The fractional delay comes from
+     * "rx_error" stream tags (or set_delay()), applied from the tagged
+     * sample onwards with a polyphase FIR; the output carries a fixed
+     * latency of max_delay + taps / 2 samples.
+     */
+    class HARMONIA_API compensation_stream : virtual public gr::sync_block
+    {
+    public:
+      typedef std::shared_ptr<compensation_stream> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of harmonia::compensation_stream.
+       *
+       * \param center_freq Carrier frequency (Hz)
+       * \param samp_rate Sample rate (Hz)
+       * \param sdr_id Platform whose estimates are applied (1-based)
+       * \param taps Fractional delay filter length (even)
+       * \param max_delay Largest delay magnitude corrected (samples)
+       */
+      static sptr make(double center_freq, double samp_rate, int sdr_id,
+                       int taps, int max_delay);
+
+      /*!
+       * \brief Set the delay correction (s), as carried by rx_error tags
+       */
+      virtual void set_delay(double t_delay) = 0;
+    };
+
+  } // namespace harmonia
+} // namespace gr
+
+#endif /* INCLUDED_HARMONIA_COMPENSATION_STREAM_H */
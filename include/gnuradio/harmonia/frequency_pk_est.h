@@ -11,6 +11,7 @@
 #include <gnuradio/block.h>
 #include <gnuradio/harmonia/api.h>
 #include <gnuradio/harmonia/device.h>
+#include <vector>
 
 namespace gr {
 namespace harmonia {
@@ -38,6 +39,25 @@ public:
 
     virtual void set_msg_queue_depth(size_t) = 0;
 
+    /*!
+     * \brief Enable FDMA mode with one baseband tone (Hz) per platform.
+     *
+     * Entry i is the tone of platform i + 1. Every other platform's tone is
+     * estimated from a single FFT of each capture and published at once as
+     * "sdr<k>", with the configured tone as "tone_sdr<k>". An empty list
+     * selects TDMA mode.
+     */
+    virtual void set_fdma_tones(const std::vector<double> &tones) = 0;
+
+    /*!
+     * \brief Treat each capture as a train of \p num_pulses pulses.
+     * Coherent: one transform of the whole capture, whose line at the tone
+     * has the full M-pulse gain but repeats every PRF. Non-coherent: the
+     * power spectra of the pulse intervals are summed, at M times coarser
+     * bin spacing. 1 disables integration; FDMA mode ignores it.
+     */
+    virtual void set_pulse_integration(int num_pulses, bool coherent) = 0;
+
     virtual void set_backend(Device::Backend) = 0;
 };
 
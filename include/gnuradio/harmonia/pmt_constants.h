@@ -1,6 +1,7 @@
 #ifndef PMT_HARMONIA_CONSTANTS
 #define PMT_HARMONIA_CONSTANTS
 #include <pmt/pmt.h>
+#include <string>
 
 // GNU-radio specific
 static const pmt::pmt_t PMT_HARMONIA_IN = pmt::intern("in");
@@ -31,6 +32,7 @@ static const pmt::pmt_t PMT_HARMONIA_F_OUT = pmt::intern("f_out");
 static const pmt::pmt_t PMT_HARMONIA_T_OUT = pmt::intern("t_out");
 static const pmt::pmt_t PMT_HARMONIA_P_OUT = pmt::intern("p_out");
 static const pmt::pmt_t PMT_HARMONIA_TP_OUT = pmt::intern("tp_out");
+static const pmt::pmt_t PMT_HARMONIA_PREDICT = pmt::intern("predict");
 
 // SigMF core
 static const pmt::pmt_t PMT_HARMONIA_GLOBAL = pmt::intern("global");
@@ -72,4 +74,22 @@ static const pmt::pmt_t PMT_HARMONIA_CP_TX_SDR3 = pmt::intern("cp_tx_sdr3");
 static const pmt::pmt_t PMT_HARMONIA_CP_RX_SDR1 = pmt::intern("cp_rx_sdr1");
 static const pmt::pmt_t PMT_HARMONIA_CP_RX_SDR2 = pmt::intern("cp_rx_sdr2");
 static const pmt::pmt_t PMT_HARMONIA_CP_RX_SDR3 = pmt::intern("cp_rx_sdr3");
+static const pmt::pmt_t PMT_HARMONIA_NUM_CAPTURES = pmt::intern("num_captures");
+static const pmt::pmt_t PMT_HARMONIA_PRIOR_DELAY = pmt::intern("prior_delay");
+static const pmt::pmt_t PMT_HARMONIA_PRIOR_UNCERTAINTY = pmt::intern("prior_uncertainty");
+static const pmt::pmt_t PMT_HARMONIA_EPOCH_TIME = pmt::intern("epoch_time");
+static const pmt::pmt_t PMT_HARMONIA_LINK_RESID = pmt::intern("link_resid");
+static const pmt::pmt_t PMT_HARMONIA_LINK_WEIGHT = pmt::intern("link_weight");
+static const pmt::pmt_t PMT_HARMONIA_BIAS_RESID = pmt::intern("bias_resid");
+static const pmt::pmt_t PMT_HARMONIA_BIAS_WEIGHT = pmt::intern("bias_weight");
+static const pmt::pmt_t PMT_HARMONIA_RX_ERROR = pmt::intern("rx_error");
+static const pmt::pmt_t PMT_HARMONIA_MF_SPECTRUM = pmt::intern("mf_spectrum");
+static const pmt::pmt_t PMT_HARMONIA_MF_NFFT = pmt::intern("mf_nfft");
+static const pmt::pmt_t PMT_HARMONIA_MF_LENGTH = pmt::intern("mf_length");
+
+// Per-platform key, e.g. harmonia_sdr_key("cfar_sdr", 2) -> "cfar_sdr2"
+inline pmt::pmt_t harmonia_sdr_key(const std::string &prefix, int id)
+{
+    return pmt::intern(prefix + std::to_string(id));
+}
 #endif /* PMT_HARMONIA_CONSTANTS */
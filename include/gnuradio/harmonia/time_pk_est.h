@@ -11,6 +11,7 @@
 #include <gnuradio/block.h>
 #include <gnuradio/harmonia/api.h>
 #include <gnuradio/harmonia/device.h>
+#include <vector>
 
 namespace gr {
 namespace harmonia {
@@ -35,6 +36,23 @@ public:
   static sptr make(double samp_rate, double bandwidth, double wait_time, double sample_delay, double NLLS_iter, int sdr_id, bool enable_out);
 
   virtual void set_msg_queue_depth(size_t depth) = 0;
+  /*!
+   * \brief Set the TDMA slot to transmitting platform mapping.
+   *
+   * Entry s is the platform number (1-based) transmitting in slot s. The
+   * number of platforms is the largest entry. Estimates for this platform's
+   * row are published once every other slot has been received.
+   */
+  virtual void set_tdma_schedule(const std::vector<int> &slot_tx) = 0;
+  /*!
+   * \brief Enable CA-CFAR detection on the correlation magnitude.
+   *
+   * The earliest of the first \p max_detections detections is used as the
+   * time estimate (falling back to the strongest peak), and every refined
+   * detection is published under "cfar_sdr<k>". \p max_detections = 0
+   * disables detection.
+   */
+  virtual void set_cfar(int guard_cells, int train_cells, double pfa, int max_detections) = 0;
   virtual void set_backend(Device::Backend) = 0;
 };
 
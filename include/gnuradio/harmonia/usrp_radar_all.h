@@ -60,6 +60,13 @@ namespace gr
                                      const std::string &sdr2_freq_key,
                                      const std::string &sample_start_key,
                                      const std::string &prf_key) = 0;
+
+      /*!
+       * \brief Select how the TX fractional delay is applied: "fft"
+       * (exact, circular) or "fir" (polyphase windowed-sinc filter of the
+       * given number of taps, O(N * taps)).
+       */
+      virtual void set_delay_method(const std::string &method, int taps) = 0;
     };
 
   } // namespace harmonia
@@ -0,0 +1,61 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_HARMONIA_USRP_RADAR_NET_H
+#define INCLUDED_HARMONIA_USRP_RADAR_NET_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/harmonia/api.h>
+#include <string>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    /*!
+     * \brief N-node USRP radar network driven by a JSON description
+     * \ingroup harmonia
+     *
+     * The description lists the radios (args, rate, freq, gains, antennas,
+     * subdevs, clock/time source, wire delays) and the synchronisation
+     * phases, each with its trigger, TDMA slots, capture length and output
+     * port. Every phase runs through the same scheduler, so growing the
+     * network is a configuration change. Node k (1-based) takes waveforms
+     * on "in" (k = 1) or "in<k>" and publishes captures on "<port>" or
+     * "<port><k>", matching the usrp_radar_all port names.
+     */
+    class HARMONIA_API usrp_radar_net : virtual public gr::block
+    {
+    public:
+      typedef std::shared_ptr<usrp_radar_net> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of harmonia::usrp_radar_net.
+       *
+       * \param config Network description, inline JSON or the path of a
+       *               JSON file
+       */
+      static sptr make(const std::string &config);
+
+      /*!
+       * \brief Select how the TX fractional delay is applied: "fft" (exact,
+       * circular) or "fir" (polyphase windowed-sinc filter of the given number
+       * of taps, O(N * taps)).
+       */
+      virtual void set_delay_method(const std::string &method, int taps) = 0;
+
+      /*!
+       * \brief Number of nodes in the network description
+       */
+      virtual int num_nodes() const = 0;
+    };
+
+  } // namespace harmonia
+} // namespace gr
+
+#endif /* INCLUDED_HARMONIA_USRP_RADAR_NET_H */
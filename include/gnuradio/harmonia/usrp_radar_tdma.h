@@ -10,6 +10,7 @@
 
 #include <gnuradio/block.h>
 #include <gnuradio/harmonia/api.h>
+#include <string>
 
 namespace gr {
 namespace harmonia {
@@ -42,6 +43,13 @@ public:
                        const double wait_time,
                        const double TDMA_time,
                        const double TDMA_time2);
+
+  /*!
+   * \brief Select how the TX fractional delay is applied: "fft" (exact,
+   * circular) or "fir" (polyphase windowed-sinc filter of the given number
+   * of taps, O(N * taps)).
+   */
+  virtual void set_delay_method(const std::string &method, int taps) = 0;
 };
 
 } // namespace harmonia
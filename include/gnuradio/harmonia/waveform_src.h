@@ -0,0 +1,63 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_HARMONIA_WAVEFORM_SRC_H
+#define INCLUDED_HARMONIA_WAVEFORM_SRC_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/harmonia/api.h>
+#include <string>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    /*!
+     * \brief Pulse source backed by the waveform library
+     * \ingroup harmonia
+     *
+     * Publishes one pulse of the named family ("lfm", "nlfm", "zadoff_chu",
+     * "barker", "costas") at start, and again for every message on "in".
+     * The PDU metadata carries the matched filter spectrum (mf_spectrum,
+     * mf_nfft, mf_length) so correlators do not rebuild it.
+     */
+    class HARMONIA_API waveform_src : virtual public gr::block
+    {
+    public:
+      typedef std::shared_ptr<waveform_src> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of harmonia::waveform_src.
+       *
+       * \param waveform Waveform family name
+       * \param samp_rate Sample rate (Hz)
+       * \param pulse_width Pulse width (s)
+       * \param bandwidth Swept bandwidth (Hz), LFM and NLFM
+       * \param code_length Number of chips, coded waveforms
+       * \param code_root Zadoff-Chu root
+       * \param prf Pulse repetition frequency (Hz), 0 for a single pulse
+       * \param zeropad Total zero padding split around the pulse (samples)
+       */
+      static sptr make(const std::string &waveform, double samp_rate, double pulse_width,
+                       double bandwidth, int code_length, int code_root, double prf,
+                       int zeropad);
+
+      /*!
+       * \brief Set the metadata keys in the PDU output
+       */
+      virtual void init_meta_dict(const std::string &bandwidth_key,
+                                  const std::string &duration_key,
+                                  const std::string &sample_rate_key,
+                                  const std::string &label_key,
+                                  const std::string &prf_key) = 0;
+    };
+
+  } // namespace harmonia
+} // namespace gr
+
+#endif /* INCLUDED_HARMONIA_WAVEFORM_SRC_H */
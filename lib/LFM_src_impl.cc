@@ -6,10 +6,18 @@
  */
 
 #include "LFM_src_impl.h"
+#include "matched_filter.h"
 #include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+#include <algorithm>
+#include <cmath>
 
 const double c = 299792458.0;
 
+// Largest phase error (rad) accepted over a pulse before a drift update
+// regenerates the cached chirp instead of reusing it
+const double alpha_phase_tol = 1e-3;
+
 namespace gr
 {
   namespace harmonia
@@ -23,57 +31,6 @@ namespace gr
           bandwidth, start_freq, center_freq, pulse_width, pulse_width2, samp_rate, prf, zeropad, sdr_id);
     }
 
-    af::array LFM(double bandwidth, double start_freq, double center_freq, double pulse_width,
-                  double samp_rate, double prf, int zeropad, double alpha_hat = 1.0, double phi_hat = 0.0, double R_hat = 0.0, double gamma_hat = 0.0)
-    {
-      // Sample interval
-      double ts = 1 / samp_rate;
-      size_t n_samp_pulse = round(samp_rate * pulse_width);
-      af::array t = (af::range(af::dim4(n_samp_pulse), -1, f64) * ts);
-
-      // LFM Phase
-      af::array phase =
-          af::Im * 2 * M_PI *
-          (start_freq * ((t) / alpha_hat) + bandwidth / (2.0 * pulse_width) * af::pow(((t) / alpha_hat), 2));
-
-      // Clock Drift Phase Correction
-      af::array cd_correction = af::Im * (2.0 * M_PI * center_freq * ((1 / alpha_hat) - 1) * t);
-
-      // Clock Bias Phase Correction
-      af::cdouble cb_scalar(0.0, -2.0 * M_PI * center_freq * phi_hat);
-      af::array cb_correction = af::constant(cb_scalar, 1, 1);
-
-      // Range Phase Correction
-      af::cdouble range_scalar(0.0, 2.0 * M_PI * center_freq * R_hat/c);
-      af::array range_correction = af::constant(range_scalar, 1, 1);
-
-      // Carrier Phase Correction
-      af::cdouble phase_scalar(0.0, -gamma_hat);
-      af::array phase_correction = af::constant(phase_scalar, 1, 1);
-
-      // Create LFM
-      af::array x = af::exp(phase + cd_correction + cb_correction + phase_correction + range_correction);
-
-      // Zero-pad to PRF
-      if (prf > 0)
-      {
-        size_t n_samp_pri = round(samp_rate / prf);
-        size_t n_pad = n_samp_pri - n_samp_pulse;
-        af::array zeros = af::constant(af::cdouble(0, 0), af::dim4(n_pad));
-        x = af::join(0, x, zeros);
-      }
-
-      if (zeropad > 0)
-      {
-        size_t n_pad = zeropad / 2;
-        af::array zeros = af::constant(af::cdouble(0, 0), af::dim4(n_pad));
-        x = af::join(0, zeros, x);
-        x = af::join(0, x, zeros);
-      }
-
-      return x;
-    }
-
     /*
      * The private constructor
      */
@@ -95,10 +52,7 @@ namespace gr
       cb_val = pmt::from_double(0.0);
       cp_val = pmt::from_double(0.0);
       R_val = pmt::from_double(0.0);
-      af::array waveform = LFM(bandwidth, start_freq, center_freq, pulse_width, samp_rate, prf, zeropad).as(c32);
-
-      d_data = pmt::init_c32vector(
-          waveform.elements(), reinterpret_cast<gr_complex *>(waveform.host<af::cfloat>()));
+      d_data = rotated_chirp(base_chirp(pulse_width, 1.0), 0.0);
 
       message_port_register_in(PMT_HARMONIA_CD_IN);
       message_port_register_in(PMT_HARMONIA_CB_IN);
@@ -119,14 +73,91 @@ namespace gr
      */
     LFM_src_impl::~LFM_src_impl() {}
 
+    LFM_src_impl::chirp_entry &LFM_src_impl::base_chirp(double width, double alpha)
+    {
+      // Reuse the cached chirp while the drift mismatch keeps the phase
+      // error over the pulse, 2*pi*f_max*T*|1/alpha - 1/alpha_cached|,
+      // below tolerance
+      auto it = d_chirp_cache.find(width);
+      if (it != d_chirp_cache.end())
+      {
+        const double f_max = std::abs(center_freq) + std::abs(start_freq) + std::abs(bandwidth);
+        const double err = 2.0 * M_PI * f_max * width * std::abs(1.0 / alpha - 1.0 / it->second.alpha);
+        if (err <= alpha_phase_tol)
+          return it->second;
+      }
+
+      // phase(t) = 2*pi*(f0*t/alpha + B/(2T)*(t/alpha)^2) + 2*pi*fc*(1/alpha - 1)*t
+      // is quadratic in the sample index: a*k + b*k^2 cycles
+      const double ts = 1.0 / samp_rate;
+      const double a = (start_freq / alpha + center_freq * (1.0 / alpha - 1.0)) * ts;
+      const double b = bandwidth / (2.0 * width) * (ts / alpha) * (ts / alpha);
+
+      chirp_entry &entry = d_chirp_cache[width];
+      entry.alpha = alpha;
+      entry.layout = pulse_train_layout(samp_rate, width, prf, zeropad);
+      entry.pulse.resize(entry.layout.pulse);
+      quadratic_phase(entry.pulse.data(), entry.pulse.size(), a, b, 0.0);
+      entry.mf.clear();
+      return entry;
+    }
+
+    pmt::pmt_t LFM_src_impl::rotated_chirp(const chirp_entry &entry, double phase)
+    {
+      // New PDU vector (published PDUs are never modified) sized once; the
+      // pulse is copied in with its rotation and the padding stays zero
+      gr_complex *out = nullptr;
+      pmt::pmt_t data = make_pulse_train(entry.layout, &out);
+      if (phase == 0.0)
+      {
+        std::copy(entry.pulse.begin(), entry.pulse.end(), out);
+        return data;
+      }
+
+      const gr_complex rot = std::polar(1.0f, static_cast<float>(std::remainder(phase, 2.0 * M_PI)));
+      volk_32fc_s32fc_multiply_32fc(out, entry.pulse.data(), rot, entry.pulse.size());
+      return data;
+    }
+
     bool LFM_src_impl::start()
     {
       // Send a PDU containing the waveform and its metadata
-      message_port_pub(PMT_HARMONIA_OUT, pmt::cons(meta, d_data));
+      pmt::pmt_t start_meta = meta;
+      if (d_attach_mf)
+        start_meta = add_mf_spectrum(meta, base_chirp(pulse_width, 1.0), 0.0);
+      message_port_pub(PMT_HARMONIA_OUT, pmt::cons(start_meta, d_data));
 
       return block::start();
     }
 
+    pmt::pmt_t LFM_src_impl::add_mf_spectrum(pmt::pmt_t meta, chirp_entry &entry, double phase)
+    {
+      // conj(flip(exp(j*phase) x)) = exp(-j*phase) conj(flip(x)), so the
+      // cached base spectrum only needs the opposite rotation
+      const pulse_layout &l = entry.layout;
+      if (entry.mf.empty())
+      {
+        af::array x = af::constant(0, l.total, c32);
+        if (l.pulse > 0)
+          x(af::seq(l.lead, l.lead + l.pulse - 1)) =
+              af::array(af::dim4(l.pulse), reinterpret_cast<const af::cfloat *>(entry.pulse.data()));
+        const dim_t nfft = mf_nfft(l.total);
+        af::array H = mf_spectrum(x, nfft);
+        entry.mf.resize(nfft);
+        H.host(reinterpret_cast<af::cfloat *>(entry.mf.data()));
+      }
+
+      pmt::pmt_t spectrum = pmt::init_c32vector(entry.mf.size(), entry.mf.data());
+      if (phase != 0.0)
+      {
+        size_t len = 0;
+        gr_complex *h = pmt::c32vector_writable_elements(spectrum, len);
+        const gr_complex rot = std::polar(1.0f, static_cast<float>(-std::remainder(phase, 2.0 * M_PI)));
+        volk_32fc_s32fc_multiply_32fc(h, h, rot, len);
+      }
+      return attach_mf_spectrum(meta, spectrum, l.total);
+    }
+
     void LFM_src_impl::handle_msg(pmt::pmt_t msg)
     {
       // Validate message is a PDU
@@ -252,23 +283,14 @@ namespace gr
       // Label Waveform
       meta = pmt::dict_add(meta, PMT_HARMONIA_LABEL, pmt::intern("LFM"));
 
-      // Generate waveform with corrected drift/bias
-      if ((pmt::equal(phase_flag, pmt::PMT_T)) || pmt::equal(bias_flag, pmt::PMT_T))
-      {
-        waveform = LFM(bandwidth, start_freq, center_freq, pulse_width2,
-                       samp_rate, prf, zeropad, alpha_hat, phi_hat, R_hat, gamma_hat)
-                       .as(c32);
-      }
-      else
-      {
-        waveform = LFM(bandwidth, start_freq, center_freq, pulse_width,
-                       samp_rate, prf, zeropad, alpha_hat, phi_hat, R_hat, gamma_hat)
-                       .as(c32);
-      }
-
-      d_data = pmt::init_c32vector(
-          waveform.elements(),
-          reinterpret_cast<gr_complex *>(waveform.host<af::cfloat>()));
+      // Drift is baked into the cached chirp; bias, range and carrier phase
+      // are one constant phase factor
+      const bool long_pulse = pmt::equal(phase_flag, pmt::PMT_T) || pmt::equal(bias_flag, pmt::PMT_T);
+      chirp_entry &entry = base_chirp(long_pulse ? pulse_width2 : pulse_width, alpha_hat);
+      const double phase = 2.0 * M_PI * center_freq * (R_hat / c - phi_hat) - gamma_hat;
+      d_data = rotated_chirp(entry, phase);
+      if (d_attach_mf)
+        meta = add_mf_spectrum(meta, entry, phase);
 
       // Send updated message
       message_port_pub(PMT_HARMONIA_OUT, pmt::cons(meta, d_data));
@@ -295,5 +317,10 @@ namespace gr
       meta = pmt::dict_add(meta, this->prf_key, pmt::from_double(prf));
     }
 
+    void LFM_src_impl::set_mf_spectrum(bool enable)
+    {
+      d_attach_mf = enable;
+    }
+
   } /* namespace harmonia */
 } /* namespace gr */
@@ -12,6 +12,9 @@
 #include <gnuradio/harmonia/pmt_constants.h>
 #include <arrayfire.h>
 #include <plasma_dsp/pulsed_waveform.h>
+#include "pulse_builder.h"
+#include <map>
+#include <vector>
 
 namespace gr
 {
@@ -35,8 +38,20 @@ namespace gr
       // Waveform object and IQ data
       pmt::pmt_t d_data;
       double alpha_hat, phi_hat, gamma_hat, R_hat;
-      af::array waveform;
-      
+
+      // Base chirp per pulse width, generated for one drift and without the
+      // constant bias/range/carrier phase, which is applied on each update
+      // as a single scalar rotation
+      struct chirp_entry
+      {
+        double alpha;
+        pulse_layout layout;
+        std::vector<gr_complex> pulse; // pulse only, without padding
+        std::vector<gr_complex> mf;    // matched filter spectrum, built on demand
+      };
+      std::map<double, chirp_entry> d_chirp_cache;
+      bool d_attach_mf = false;
+
       // Metadata fields
       pmt::pmt_t label_key;
       pmt::pmt_t sample_rate_key;
@@ -50,6 +65,9 @@ namespace gr
       pmt::pmt_t R_val;
 
       void handle_msg(pmt::pmt_t msg);
+      chirp_entry &base_chirp(double width, double alpha);
+      pmt::pmt_t rotated_chirp(const chirp_entry &entry, double phase);
+      pmt::pmt_t add_mf_spectrum(pmt::pmt_t meta, chirp_entry &entry, double phase);
 
     public:
       LFM_src_impl(double bandwidth,
@@ -70,6 +88,8 @@ namespace gr
                           const std::string &sample_rate_key,
                           const std::string &label_key,
                           const std::string &prf_key);
+
+      void set_mf_spectrum(bool enable) override;
     };
 
   } // namespace harmonia
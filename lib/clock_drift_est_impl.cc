@@ -7,6 +7,7 @@
 
 #include "clock_drift_est_impl.h"
 #include <gnuradio/io_signature.h>
+#include <sstream>
 
 namespace gr
 {
@@ -31,8 +32,17 @@ namespace gr
           pulse_width(pulse_width),
           SNR(SNR),
           d_store(num_platforms*(num_platforms-1), 0.0),
-          d_got(num_platforms*(num_platforms-1), false)
+          d_got(num_platforms*(num_platforms-1), false),
+          d_tone(num_platforms*(num_platforms-1), baseband_freq),
+          d_var(num_platforms*(num_platforms-1), 0.0),
+          d_rx_seen(num_platforms, false),
+          d_robust(robust_kind::NONE),
+          d_tuning(1.345)
     {
+      // Nominal frequency CRLB, used for links that do not report one
+      d_var_nominal = 3 / (2 * std::pow(M_PI, 2.0) * std::pow(pulse_width, 3.0) * samp_rate *
+                           std::pow(10.0, SNR / 10.0) * (1.0 - std::pow(1.0 / (pulse_width * samp_rate), 2.0)));
+
       meta = pmt::make_dict();
       message_port_register_in(PMT_HARMONIA_IN);
       message_port_register_in(PMT_HARMONIA_IN2);
@@ -52,6 +62,12 @@ namespace gr
      */
     clock_drift_est_impl::~clock_drift_est_impl() {}
 
+    void clock_drift_est_impl::set_robust_estimator(const std::string &kind, double tuning)
+    {
+      d_robust = robust_kind_from_string(kind);
+      d_tuning = tuning;
+    }
+
     void clock_drift_est_impl::handle_msg(pmt::pmt_t msg)
     {
       // 1) Extract incoming dict
@@ -66,146 +82,124 @@ namespace gr
       // Extract SDR
       pmt::pmt_t rx_pmt = pmt::dict_ref(dict, pmt::intern("rx_id"), pmt::PMT_NIL);
       int rx = -1;
-      if (rx_pmt == PMT_HARMONIA_SDR1)
-        rx = 0;
-      else if (rx_pmt == PMT_HARMONIA_SDR2)
-        rx = 1;
-      else if (rx_pmt == PMT_HARMONIA_SDR3)
-        rx = 2;
-      else
+      for (int k = 0; k < num_platforms; ++k)
+      {
+        if (pmt::eqv(rx_pmt, harmonia_sdr_key("sdr", k + 1)))
+        {
+          rx = k;
+          break;
+        }
+      }
+      if (rx < 0)
         return;
 
-      // Map (rx,tx)
-      // Order: (2,1)->0, (3,1)->1, (1,2)->2, (3,2)->3, (1,3)->4, (2,3)->5
-      static const int idx_map[3][3] = {
-          /*tx=1*/ {-1, 2, 4}, // rx=1,2,3
-          /*tx=2*/ {0, -1, 5},
-          /*tx=3*/ {1, 3, -1}};
-
-      // For each other SDR where tx != rx, extract its float-vector
-      static const pmt::pmt_t sdr_syms[3] = {
-          PMT_HARMONIA_SDR1,
-          PMT_HARMONIA_SDR2,
-          PMT_HARMONIA_SDR3};
-
-      for (int tx = 0; tx < 3; ++tx)
+      // For each other SDR where tx != rx, extract its float-vector. A link
+      // without a valid estimate in this rx's report is dropped from the
+      // solve until it reappears.
+      for (int tx = 0; tx < num_platforms; ++tx)
       {
         if (tx == rx)
           continue;
-        pmt::pmt_t vec_pmt = pmt::dict_ref(dict, sdr_syms[tx], pmt::PMT_NIL);
-        if (!pmt::is_f32vector(vec_pmt))
-          return; // wait until this SDR’s data arrives
-        auto tmpf = pmt::f32vector_elements(vec_pmt);
-        if (tmpf.size() != 1)
-          return;               
-        double f_est = tmpf[0]; 
-
-        int idx = idx_map[rx][tx];
-        d_store[idx] = f_est + center_freq; 
-        d_got[idx] = true;                  
+        size_t idx = link_index(tx, rx);
+        d_got[idx] = false;
+
+        pmt::pmt_t vec_pmt = pmt::dict_ref(dict, harmonia_sdr_key("sdr", tx + 1), pmt::PMT_NIL);
+        if (!pmt::is_f32vector(vec_pmt) || pmt::length(vec_pmt) != 1)
+          continue;
+        double f_est = pmt::f32vector_ref(vec_pmt, 0);
+        if (!std::isfinite(f_est))
+          continue;
+
+        d_store[idx] = f_est + center_freq;
+        d_got[idx] = true;
+
+        // FDMA captures carry the transmitter's own baseband tone
+        pmt::pmt_t tone_pmt = pmt::dict_ref(dict, harmonia_sdr_key("tone_sdr", tx + 1), pmt::PMT_NIL);
+        d_tone[idx] = pmt::is_number(tone_pmt) ? pmt::to_double(tone_pmt) : baseband_freq;
+
+        // Measured CRLB from the peak estimator, else the nominal one
+        pmt::pmt_t var_pmt = pmt::dict_ref(dict, harmonia_sdr_key("var_sdr", tx + 1), pmt::PMT_NIL);
+        d_var[idx] = d_var_nominal;
+        if (pmt::is_f64vector(var_pmt) && pmt::length(var_pmt) > 0)
+        {
+          double v = pmt::f64vector_ref(var_pmt, 0);
+          if (std::isfinite(v) && v > 0.0)
+            d_var[idx] = v;
+        }
       }
 
-      // Wait until all six values have been received
-      if (!std::all_of(d_got.begin(), d_got.end(), [](bool b)
+      // Wait until every platform has reported
+      d_rx_seen[rx] = true;
+      if (!std::all_of(d_rx_seen.begin(), d_rx_seen.end(), [](bool b)
                        { return b; }))
         return;
 
-      // Build A_est
-      std::vector<std::vector<double>> A_est;
-      A_est.reserve(d_store.size() + 1);
-      for (int n = 0; n < (int)d_store.size(); ++n)
+      // Linearised incidence model with alpha = 1 + e: each active link
+      // (tx, rx) gives  e_tx - e_rx = (f_rx - F) / F,  F = tone + fc, to
+      // first order in e (~1e-6, so the dropped term is ~1e-12). The design
+      // then depends only on which links are active, and the weighted
+      // pseudo-inverse is reused until that set or the weights change.
+      // Weights are inverse variances of the normalised observation; the
+      // anchor only fixes the common offset, so its weight is arbitrary and
+      // set to the mean link weight for conditioning.
+      d_rows.clear();
+      d_w.clear();
+      d_y.clear();
+      d_row_link.clear();
+      double w_sum = 0.0;
+      for (size_t n = 0; n < d_store.size(); ++n)
       {
-        int rx_i, tx_i;
-        switch (n)
-        {
-        case 0:
-          rx_i = 1;
-          tx_i = 0;
-          break; // (2,1)
-        case 1:
-          rx_i = 2;
-          tx_i = 0;
-          break; // (3,1)
-        case 2:
-          rx_i = 0;
-          tx_i = 1;
-          break; // (1,2)
-        case 3:
-          rx_i = 2;
-          tx_i = 1;
-          break; // (3,2)
-        case 4:
-          rx_i = 0;
-          tx_i = 2;
-          break; // (1,3)
-        case 5:
-          rx_i = 1;
-          tx_i = 2;
-          break; // (2,3)
-        }
-        std::vector<double> row(num_platforms, 0.0);
-        row[rx_i] = d_store[n];
-        row[tx_i] = -(baseband_freq + center_freq);
-        A_est.push_back(row);
+        if (!d_got[n])
+          continue;
+        size_t tx_i = n / (num_platforms - 1);
+        size_t rx_i = n % (num_platforms - 1);
+        if (rx_i >= tx_i)
+          rx_i++;
+        double F = d_tone[n] + center_freq;
+        d_rows.push_back({tx_i, 1.0, rx_i, -1.0});
+        d_w.push_back(F * F / d_var[n]);
+        d_y.push_back((d_store[n] - F) / F);
+        d_row_link.push_back(n);
+        w_sum += d_w.back();
       }
       // Assumption alpha_1 = 1.0
+      d_rows.push_back({0, 1.0, 0, 0.0});
+      d_w.push_back(d_row_link.empty() ? 1.0 : w_sum / d_row_link.size());
+      d_y.push_back(0.0);
+
+      if (!d_pinv.update(num_platforms, d_rows, d_w))
       {
-        std::vector<double> ref(num_platforms, 0.0);
-        ref[0] = center_freq;
-        A_est.push_back(ref);
+        GR_LOG_WARN(d_logger, "active links do not constrain every platform's drift");
+        return;
       }
 
-      // Flatten for ArrayFire
-      std::vector<double> flat(num_platforms * A_est.size(), 0.0);
-      for (size_t r = 0; r < A_est.size(); ++r)
+      // Plain WLS, or IRLS re-solves through the same pseudo-inverse
+      std::vector<double> x_host, resid, weight;
+      robust_solve(d_pinv, d_w, d_y, d_row_link.size(), d_robust, d_tuning,
+                   x_host, resid, weight);
+      for (double &x : x_host)
+        x += 1.0;
+
+      // Per-link residual (relative frequency) and IRLS weight, tx-major
+      // link order, NaN for links not in the solve
+      std::vector<double> link_resid(d_store.size(), std::numeric_limits<double>::quiet_NaN());
+      std::vector<double> link_weight(d_store.size(), std::numeric_limits<double>::quiet_NaN());
+      for (size_t r = 0; r < d_row_link.size(); ++r)
       {
-        for (int c = 0; c < num_platforms; ++c)
-        {
-          flat[c * A_est.size() + r] = A_est[r][c];
-        }
+        link_resid[d_row_link[r]] = resid[r];
+        link_weight[d_row_link[r]] = weight[r];
       }
+      meta = pmt::dict_add(meta, PMT_HARMONIA_LINK_RESID, pmt::init_f64vector(link_resid.size(), link_resid));
+      meta = pmt::dict_add(meta, PMT_HARMONIA_LINK_WEIGHT, pmt::init_f64vector(link_weight.size(), link_weight));
 
-      // Matrix for Linear System of Equations
-      af::dim4 dims(A_est.size(), num_platforms);
-      A_mat = af::array(dims, flat.data(), afHost);
-      A_mat = A_mat.as(f64);
-      // af_print(A_mat);
-
-      af::array y = af::join(0, af::constant(0.0, A_est.size() - 1, f64), af::constant(center_freq, 1, f64));
-
-      // Compute variance
-      double var_f = 3 / (2 * std::pow(af::Pi, 2.0) * std::pow(pulse_width, 3.0) * samp_rate *
-                          std::pow(10.0, SNR / 10.0) * (1.0 - std::pow(1.0 / (pulse_width * samp_rate), 2.0)));
-
-      // Diagonalize noise/weight matrix according to SNR
-      af::array diag_vals = af::join(0,
-                                     af::constant(var_f, A_est.size() - 1, f64),
-                                     af::constant(1e-12, 1, f64));
-      af::array Cov_mat = af::diag(diag_vals, 0, false);
-      af::array inv_Cov_mat = af::inverse(Cov_mat);
-
-      // Solve Weighted Least Squares
-      af::array At_Cinv = af::matmulTN(A_mat, inv_Cov_mat);
-      af::array lhs = af::matmul(At_Cinv, A_mat);
-      af::array rhs = af::matmul(At_Cinv, y);
-      af::array x_alpha = af::solve(lhs, rhs);
-
-      // Output estimates
-      std::vector<double> x_host(x_alpha.elements());
-      x_alpha.host(x_host.data());
-
-      // Print estimates
-      std::cout << "x_alpha (Hz):" << std::endl;
-      for (double val : x_host)
-        std::cout << std::fixed << std::setprecision(13) << val << std::endl;
-
-      // Publish results once
-      meta = pmt::dict_add(meta, PMT_HARMONIA_SDR1, pmt::from_double(1.00000));
-      meta = pmt::dict_add(meta, PMT_HARMONIA_SDR2, pmt::from_double(1.0000));
-      meta = pmt::dict_add(meta, PMT_HARMONIA_SDR3, pmt::from_double(1.0000));
-      // meta = pmt::dict_add(meta, PMT_HARMONIA_SDR1, pmt::from_double(x_host[0]));
-      // meta = pmt::dict_add(meta, PMT_HARMONIA_SDR2, pmt::from_double(x_host[1]));
-      // meta = pmt::dict_add(meta, PMT_HARMONIA_SDR3, pmt::from_double(x_host[2]));
+      // Log and publish the estimates once
+      for (int k = 0; k < num_platforms; ++k)
+      {
+        std::ostringstream msg;
+        msg << "sdr" << k + 1 << " x_alpha: " << std::fixed << std::setprecision(13) << x_host[k];
+        GR_LOG_DEBUG(d_logger, msg.str());
+        meta = pmt::dict_add(meta, harmonia_sdr_key("sdr", k + 1), pmt::from_double(x_host[k]));
+      }
       meta = pmt::dict_add(meta, pmt::intern("clock_drift_enable"), pmt::PMT_T);
       message_port_pub(PMT_HARMONIA_OUT, meta);
 
@@ -10,9 +10,12 @@
 
 #include <gnuradio/harmonia/clock_drift_est.h>
 #include <gnuradio/harmonia/pmt_constants.h>
-#include <arrayfire.h>
+#include "wls.h"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iomanip>
+#include <limits>
 namespace gr
 {
   namespace harmonia
@@ -29,12 +32,26 @@ namespace gr
       double pulse_width;
       double SNR;
       double freq_val;
-      af::array A_mat;
+      double d_var_nominal;
 
       // Object and data
       pmt::pmt_t d_data;
       std::vector<double> d_store;
       std::vector<bool> d_got;
+      std::vector<double> d_tone;
+      std::vector<double> d_var;
+      std::vector<bool> d_rx_seen;
+
+      // Active-link design, weights and observations, and the cached solver
+      std::vector<wls_row> d_rows;
+      std::vector<double> d_w;
+      std::vector<double> d_y;
+      std::vector<size_t> d_row_link;
+      wls_pinv d_pinv;
+
+      // Robust estimator
+      robust_kind d_robust;
+      double d_tuning;
 
       // Metadata fields
       pmt::pmt_t meta;
@@ -42,6 +59,12 @@ namespace gr
       // Functions
       void handle_msg(pmt::pmt_t msg);
 
+      // Links are stored tx-major, skipping tx == rx (0-based ids)
+      size_t link_index(int tx, int rx) const
+      {
+        return tx * (num_platforms - 1) + (rx < tx ? rx : rx - 1);
+      }
+
     public:
       clock_drift_est_impl(int num_platforms,
                            double baseband_freq,
@@ -50,6 +73,8 @@ namespace gr
                            double pulse_width,
                            double SNR);
       ~clock_drift_est_impl();
+
+      void set_robust_estimator(const std::string &kind, double tuning) override;
     };
 
   } // namespace harmonia
@@ -0,0 +1,243 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "clock_state_tracker_impl.h"
+#include <gnuradio/io_signature.h>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    // Initial (diffuse) prior: 1 s bias, 100 ppm drift, any phase
+    static const std::array<double, 3> initial_var = {1.0, 1e-8, M_PI * M_PI};
+
+    clock_state_tracker::sptr clock_state_tracker::make(int num_platforms, double center_freq,
+                                                        double q_bias, double q_drift, double q_phase,
+                                                        double r_bias, double r_drift, double r_phase)
+    {
+      return gnuradio::make_block_sptr<clock_state_tracker_impl>(num_platforms, center_freq,
+                                                                 q_bias, q_drift, q_phase,
+                                                                 r_bias, r_drift, r_phase);
+    }
+
+    /*
+     * The private constructor
+     */
+    clock_state_tracker_impl::clock_state_tracker_impl(int num_platforms,
+                                                       double center_freq,
+                                                       double q_bias,
+                                                       double q_drift,
+                                                       double q_phase,
+                                                       double r_bias,
+                                                       double r_drift,
+                                                       double r_phase)
+        : gr::block("clock_state_tracker",
+                    gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0)),
+          num_platforms(num_platforms),
+          center_freq(center_freq),
+          d_q{q_bias, q_drift, q_phase},
+          d_r{r_bias, r_drift, r_phase},
+          d_start(std::chrono::steady_clock::now())
+    {
+      reset();
+
+      message_port_register_in(PMT_HARMONIA_IN);
+      message_port_register_in(PMT_HARMONIA_PREDICT);
+      message_port_register_out(PMT_HARMONIA_OUT);
+
+      set_msg_handler(PMT_HARMONIA_IN, [this](pmt::pmt_t msg)
+                      { handle_msg(msg); });
+      set_msg_handler(PMT_HARMONIA_PREDICT, [this](pmt::pmt_t msg)
+                      { handle_predict(msg); });
+    }
+
+    /*
+     * Our virtual destructor.
+     */
+    clock_state_tracker_impl::~clock_state_tracker_impl() {}
+
+    void clock_state_tracker_impl::reset()
+    {
+      node_state init;
+      init.x = {0.0, 0.0, 0.0};
+      init.P.fill(0.0);
+      for (int i = 0; i < 3; ++i)
+        init.P[i * 3 + i] = initial_var[i];
+
+      d_nodes.assign(num_platforms, init);
+      d_have_time = false;
+      d_last_time = 0.0;
+    }
+
+    pmt::pmt_t clock_state_tracker_impl::extract_dict(pmt::pmt_t msg)
+    {
+      if (pmt::is_dict(msg))
+        return msg;
+      if (pmt::is_pair(msg) && pmt::is_dict(pmt::car(msg)))
+        return pmt::car(msg);
+      return pmt::PMT_NIL;
+    }
+
+    double clock_state_tracker_impl::epoch_time(pmt::pmt_t dict)
+    {
+      pmt::pmt_t t = pmt::dict_ref(dict, PMT_HARMONIA_EPOCH_TIME, pmt::PMT_NIL);
+      if (pmt::is_number(t))
+        return pmt::to_double(t);
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - d_start).count();
+    }
+
+    void clock_state_tracker_impl::predict(node_state &s, double dt) const
+    {
+      if (dt <= 0.0)
+        return;
+
+      // Bias integrates drift; phase advances at 2*pi*fc*drift
+      const double w = 2.0 * M_PI * center_freq * dt;
+      const double F[9] = {1.0, dt, 0.0,
+                           0.0, 1.0, 0.0,
+                           0.0, w, 1.0};
+
+      s.x[BIAS] += dt * s.x[DRIFT];
+      s.x[PHASE] = std::remainder(s.x[PHASE] + w * s.x[DRIFT], 2.0 * M_PI);
+
+      // P = F P F' + Q dt
+      double FP[9];
+      for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+          FP[i * 3 + j] = F[i * 3 + 0] * s.P[0 * 3 + j] +
+                          F[i * 3 + 1] * s.P[1 * 3 + j] +
+                          F[i * 3 + 2] * s.P[2 * 3 + j];
+      for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+          s.P[i * 3 + j] = FP[i * 3 + 0] * F[j * 3 + 0] +
+                           FP[i * 3 + 1] * F[j * 3 + 1] +
+                           FP[i * 3 + 2] * F[j * 3 + 2];
+      for (int i = 0; i < 3; ++i)
+        s.P[i * 3 + i] += d_q[i] * dt;
+    }
+
+    void clock_state_tracker_impl::update(node_state &s, int i, double z) const
+    {
+      // Scalar measurement of state component i: H = e_i, so the update
+      // only needs column i of P
+      double nu = z - s.x[i];
+      if (i == PHASE)
+        nu = std::remainder(nu, 2.0 * M_PI);
+
+      const double S = s.P[i * 3 + i] + d_r[i];
+      if (!(S > 0.0))
+        return;
+
+      std::array<double, 3> K, Pi;
+      for (int j = 0; j < 3; ++j)
+      {
+        Pi[j] = s.P[i * 3 + j];
+        K[j] = Pi[j] / S;
+      }
+
+      for (int j = 0; j < 3; ++j)
+        s.x[j] += K[j] * nu;
+      s.x[PHASE] = std::remainder(s.x[PHASE], 2.0 * M_PI);
+
+      // P = (I - K H) P, symmetrised
+      for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c)
+          s.P[r * 3 + c] -= K[r] * Pi[c];
+      for (int r = 0; r < 3; ++r)
+        for (int c = r + 1; c < 3; ++c)
+          s.P[r * 3 + c] = s.P[c * 3 + r] = 0.5 * (s.P[r * 3 + c] + s.P[c * 3 + r]);
+    }
+
+    void clock_state_tracker_impl::handle_msg(pmt::pmt_t msg)
+    {
+      pmt::pmt_t dict = extract_dict(msg);
+      if (pmt::is_null(dict))
+      {
+        GR_LOG_WARN(d_logger, "Expected a dict or PDU, ignoring.");
+        return;
+      }
+
+      // Propagate everyone to this epoch, then fold in what it measured
+      double t = epoch_time(dict);
+      if (d_have_time)
+      {
+        double dt = t - d_last_time;
+        for (auto &s : d_nodes)
+          predict(s, dt);
+      }
+      d_last_time = t;
+      d_have_time = true;
+
+      bool updated = false;
+      for (int k = 0; k < num_platforms; ++k)
+      {
+        node_state &s = d_nodes[k];
+
+        pmt::pmt_t alpha = pmt::dict_ref(dict, harmonia_sdr_key("sdr", k + 1), pmt::PMT_NIL);
+        if (pmt::is_real(alpha))
+        {
+          update(s, DRIFT, pmt::to_double(alpha) - 1.0);
+          updated = true;
+        }
+
+        pmt::pmt_t bias = pmt::dict_ref(dict, harmonia_sdr_key("cb_sdr", k + 1), pmt::PMT_NIL);
+        if (pmt::is_real(bias))
+        {
+          update(s, BIAS, pmt::to_double(bias));
+          updated = true;
+        }
+
+        pmt::pmt_t phase = pmt::dict_ref(dict, harmonia_sdr_key("cp_tx_sdr", k + 1), pmt::PMT_NIL);
+        if (pmt::is_real(phase))
+        {
+          update(s, PHASE, pmt::to_double(phase));
+          updated = true;
+        }
+      }
+
+      if (updated)
+        publish(d_nodes, t, false);
+    }
+
+    void clock_state_tracker_impl::handle_predict(pmt::pmt_t msg)
+    {
+      pmt::pmt_t dict = extract_dict(msg);
+      double t = epoch_time(pmt::is_null(dict) ? pmt::make_dict() : dict);
+
+      // Propagate a copy; the filter state only moves on measurements
+      std::vector<node_state> nodes = d_nodes;
+      if (d_have_time)
+      {
+        double dt = t - d_last_time;
+        for (auto &s : nodes)
+          predict(s, dt);
+      }
+      publish(nodes, t, true);
+    }
+
+    void clock_state_tracker_impl::publish(const std::vector<node_state> &nodes, double t, bool predicted)
+    {
+      // Same keys as the batch estimators, so the tracker can stand in for them
+      pmt::pmt_t meta = pmt::make_dict();
+      for (int k = 0; k < num_platforms; ++k)
+      {
+        const node_state &s = nodes[k];
+        meta = pmt::dict_add(meta, harmonia_sdr_key("sdr", k + 1), pmt::from_double(1.0 + s.x[DRIFT]));
+        meta = pmt::dict_add(meta, harmonia_sdr_key("cb_sdr", k + 1), pmt::from_double(s.x[BIAS]));
+        meta = pmt::dict_add(meta, harmonia_sdr_key("cp_tx_sdr", k + 1), pmt::from_double(s.x[PHASE]));
+
+        std::vector<double> var = {s.P[0], s.P[4], s.P[8]};
+        meta = pmt::dict_add(meta, harmonia_sdr_key("state_var_sdr", k + 1), pmt::init_f64vector(var.size(), var));
+      }
+      meta = pmt::dict_add(meta, PMT_HARMONIA_EPOCH_TIME, pmt::from_double(t));
+      meta = pmt::dict_add(meta, pmt::intern("clock_state_predicted"), pmt::from_bool(predicted));
+      message_port_pub(PMT_HARMONIA_OUT, meta);
+    }
+
+  } /* namespace harmonia */
+} /* namespace gr */
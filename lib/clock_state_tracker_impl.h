@@ -0,0 +1,79 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_HARMONIA_CLOCK_STATE_TRACKER_IMPL_H
+#define INCLUDED_HARMONIA_CLOCK_STATE_TRACKER_IMPL_H
+
+#include <gnuradio/harmonia/clock_state_tracker.h>
+#include <gnuradio/harmonia/pmt_constants.h>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    class clock_state_tracker_impl : public clock_state_tracker
+    {
+    private:
+      // Parameters
+      int num_platforms;
+      double center_freq;
+      std::array<double, 3> d_q; // process noise per second
+      std::array<double, 3> d_r; // measurement variance
+
+      // State index
+      enum
+      {
+        BIAS = 0,
+        DRIFT = 1,
+        PHASE = 2
+      };
+
+      // Per-platform state x = [bias, drift, phase] and row-major 3x3 covariance
+      struct node_state
+      {
+        std::array<double, 3> x;
+        std::array<double, 9> P;
+      };
+      std::vector<node_state> d_nodes;
+
+      // Time of the last update (s); epochs without epoch_time use a steady clock
+      double d_last_time;
+      bool d_have_time;
+      std::chrono::steady_clock::time_point d_start;
+
+      // Functions
+      void handle_msg(pmt::pmt_t msg);
+      void handle_predict(pmt::pmt_t msg);
+      pmt::pmt_t extract_dict(pmt::pmt_t msg);
+      double epoch_time(pmt::pmt_t dict);
+      void predict(node_state &s, double dt) const;
+      void update(node_state &s, int i, double z) const;
+      void publish(const std::vector<node_state> &nodes, double t, bool predicted);
+
+    public:
+      clock_state_tracker_impl(int num_platforms,
+                               double center_freq,
+                               double q_bias,
+                               double q_drift,
+                               double q_phase,
+                               double r_bias,
+                               double r_drift,
+                               double r_phase);
+      ~clock_state_tracker_impl();
+
+      void reset() override;
+    };
+
+  } // namespace harmonia
+} // namespace gr
+
+#endif /* INCLUDED_HARMONIA_CLOCK_STATE_TRACKER_IMPL_H */
@@ -51,9 +51,30 @@ namespace gr
           phase_status(phase_status),
           time_matrix(num_platforms, std::vector<double>(num_platforms, 0.0)),
           phase_matrix(num_platforms, std::vector<double>(num_platforms, 0.0)),
+          var_matrix(num_platforms, std::vector<double>(num_platforms, 0.0)),
           check_time(num_platforms, false),
-          check_phase(num_platforms, false)
+          check_phase(num_platforms, false),
+          d_alpha(num_platforms, 1.0),
+          d_phase_ok(false),
+          d_robust(robust_kind::NONE),
+          d_tuning(1.345)
     {
+      // Every possible phase link in row order; the nominal CRLB weights them
+      for (int jj = 0; jj < num_platforms; ++jj)
+        for (int ii = 0; ii < num_platforms; ++ii)
+          if (ii != jj)
+            d_phase_links.emplace_back(jj, ii);
+      d_link_active.assign(d_phase_links.size(), false);
+      d_time_active.assign(d_phase_links.size(), false);
+
+      double var_f = 3.0 /
+                     (2.0 * std::pow(M_PI, 2.0) *
+                      std::pow(pulse_width, 3.0) *
+                      samp_rate *
+                      std::pow(10.0, (SNR / 10.0)) *
+                      (1.0 - std::pow(1.0 / (pulse_width * samp_rate), 2.0)));
+      d_phase_w = 1.0 / var_f;
+
       meta = pmt::make_dict();
       message_port_register_in(PMT_HARMONIA_IN);
       message_port_register_in(PMT_HARMONIA_IN2);
@@ -76,32 +97,72 @@ namespace gr
      */
     clockbias_phase_est_impl::~clockbias_phase_est_impl() {}
 
-    af::array clockbias_phase_est_impl::to_af_array(const std::vector<std::vector<double>> &matrix)
+    void clockbias_phase_est_impl::set_robust_estimator(const std::string &kind, double tuning)
+    {
+      d_robust = robust_kind_from_string(kind);
+      d_tuning = tuning;
+    }
+
+    // Wrap an angle to [-pi, pi)
+    static double wrap_to_pi(double angle)
     {
-      int rows = matrix.size();
-      int cols = matrix[0].size();
-      std::vector<double> flat(rows * cols);
+      const double two_pi = 2.0 * M_PI;
+      return angle - two_pi * std::floor((angle + M_PI) / two_pi);
+    }
 
-      for (int r = 0; r < rows; ++r)
+    bool clockbias_phase_est_impl::update_phase_solver()
+    {
+      // Unknowns: TX phases 0..N-1, then RX phases N..2N-1. One row per
+      // active (tx, rx) link, tx outer and rx inner, t_tx - r_rx =
+      // gamma(rx, tx), then the anchor row t_0 = 0.
+      const int N = num_platforms;
+      const int ntrans = 2 * N;
+      d_phase_rows.clear();
+      d_phase_active.clear();
+      for (size_t r = 0; r < d_phase_links.size(); ++r)
       {
-        for (int c = 0; c < cols; ++c)
+        if (!d_link_active[r])
+          continue;
+        d_phase_rows.push_back({static_cast<size_t>(d_phase_links[r].first), 1.0,
+                                static_cast<size_t>(N + d_phase_links[r].second), -1.0});
+        d_phase_active.push_back(r);
+      }
+      d_phase_rows.push_back({0, 1.0, 0, 0.0});
+      std::vector<double> w(d_phase_rows.size(), d_phase_w);
+      w.back() = 1.0 / 1e-12;
+
+      // The weighted pseudo-inverse (A' W A)^-1 A' W only depends on the
+      // set of active links; it and the spanning tree are rebuilt only when
+      // that set changes
+      bool rebuilt;
+      if (!d_phase_pinv.update(ntrans, d_phase_rows, w, &rebuilt))
+        return false;
+      if (!rebuilt)
+        return d_phase_ok;
+
+      // Spanning tree from the anchor, walked breadth first and replayed
+      // per epoch for the initial solution
+      d_phase_tree.clear();
+      std::vector<bool> seen(ntrans, false);
+      std::vector<int> queue = {0};
+      seen[0] = true;
+      for (size_t q = 0; q < queue.size(); ++q)
+      {
+        int from = queue[q];
+        for (size_t r = 0; r + 1 < d_phase_rows.size(); ++r)
         {
-          flat[c * rows + r] = matrix[r][c];
+          int t = d_phase_rows[r].c0;
+          int x = d_phase_rows[r].c1;
+          int to = (from == t) ? x : (from == x) ? t : -1;
+          if (to < 0 || seen[to])
+            continue;
+          seen[to] = true;
+          queue.push_back(to);
+          d_phase_tree.push_back({static_cast<int>(r), from, to});
         }
       }
-
-      return af::array(rows, cols, flat.data());
-    }
-
-    // Function to wrap Pi values between -pi to pi
-    af::array wrapToPi_af(const af::array &angle)
-    {
-      const double pi = M_PI;
-      const double twoπ = 2.0 * pi;
-      af::array tmp = (angle + pi) / twoπ;
-      af::array round_val = af::floor(tmp);
-
-      return angle - (twoπ * round_val);
+      d_phase_ok = static_cast<int>(queue.size()) == ntrans;
+      return d_phase_ok;
     }
 
     void clockbias_phase_est_impl::handle_clock_drift(pmt::pmt_t msg)
@@ -114,31 +175,28 @@ namespace gr
       }
 
       double default_alpha = 1.0;
-      alpha1 = pmt::to_double(pmt::dict_ref(msg, PMT_HARMONIA_SDR1, pmt::from_double(default_alpha)));
-      alpha2 = pmt::to_double(pmt::dict_ref(msg, PMT_HARMONIA_SDR2, pmt::from_double(default_alpha)));
-      alpha3 = pmt::to_double(pmt::dict_ref(msg, PMT_HARMONIA_SDR3, pmt::from_double(default_alpha)));
-      // std::cout << std::fixed << std::setprecision(12)
-      // << "alpha1 = " << alpha1 << "\n"
-      // << "alpha2 = " << alpha2 << "\n"
-      // << "alpha3 = " << alpha3 << std::endl;
+      for (int k = 0; k < num_platforms; ++k)
+        d_alpha[k] = pmt::to_double(pmt::dict_ref(msg, harmonia_sdr_key("sdr", k + 1), pmt::from_double(default_alpha)));
     }
 
     void clockbias_phase_est_impl::handle_msg(pmt::pmt_t msg)
     {
-      // Check for incoming message
+      // Check for incoming message. The per-link keys are read from this
+      // report only, so a key it leaves out never picks up another
+      // receiver's value from an earlier report
+      pmt::pmt_t incoming_meta;
       if (pmt::is_pair(msg))
       {
-        pmt::pmt_t incoming_meta = pmt::car(msg);
+        incoming_meta = pmt::car(msg);
         if (!pmt::is_dict(incoming_meta))
         {
           GR_LOG_ERROR(d_logger, "PDU car() is not a dict");
           return;
         }
-        d_meta = pmt::dict_update(d_meta, incoming_meta);
       }
       else if (pmt::is_dict(msg))
       {
-        d_meta = pmt::dict_update(d_meta, msg);
+        incoming_meta = msg;
       }
       else
       {
@@ -147,24 +205,19 @@ namespace gr
       }
 
       // Extract SDR RX ID
-      pmt::pmt_t rx_pmt = pmt::dict_ref(d_meta, pmt::intern("rx_id"), pmt::PMT_NIL);
+      pmt::pmt_t rx_pmt = pmt::dict_ref(incoming_meta, pmt::intern("rx_id"), pmt::PMT_NIL);
       int rx = -1;
-      if (rx_pmt == PMT_HARMONIA_SDR1)
-        rx = 0;
-      else if (rx_pmt == PMT_HARMONIA_SDR2)
-        rx = 1;
-      else if (rx_pmt == PMT_HARMONIA_SDR3)
-        rx = 2;
-      else
+      for (int k = 0; k < num_platforms; ++k)
+      {
+        if (pmt::eqv(rx_pmt, harmonia_sdr_key("sdr", k + 1)))
+        {
+          rx = k;
+          break;
+        }
+      }
+      if (rx < 0)
         return;
 
-      pmt::pmt_t sdr_syms[num_platforms] = {PMT_HARMONIA_SDR1,
-                                            PMT_HARMONIA_SDR2,
-                                            PMT_HARMONIA_SDR3};
-      pmt::pmt_t phase_syms[num_platforms] = {PMT_HARMONIA_P_SDR1,
-                                              PMT_HARMONIA_P_SDR2,
-                                              PMT_HARMONIA_P_SDR3};
-
       // Sort incoming data into their designated time/phase matrices
       for (int tx = 0; tx < num_platforms; ++tx)
       {
@@ -173,28 +226,31 @@ namespace gr
           continue;
 
         // Time Matrix
-        if (pmt::dict_has_key(d_meta, sdr_syms[tx]))
+        bool have_time = false, have_phase = false;
+        auto v = pmt::dict_ref(incoming_meta, harmonia_sdr_key("sdr", tx + 1), pmt::PMT_NIL);
+        if (pmt::is_f64vector(v) && pmt::length(v) > 0)
         {
-          auto v = pmt::dict_ref(d_meta, sdr_syms[tx], pmt::PMT_NIL);
-          if (pmt::is_f64vector(v))
-          {
-            auto tmp = pmt::f64vector_elements(v);
-            if (!tmp.empty())
-              time_matrix[rx][tx] = tmp[0];
-          }
+          time_matrix[rx][tx] = pmt::f64vector_ref(v, 0);
+          have_time = true;
         }
 
+        // Time CRLB, when reported (NaN entries are not reported)
+        v = pmt::dict_ref(incoming_meta, harmonia_sdr_key("var_sdr", tx + 1), pmt::PMT_NIL);
+        var_matrix[rx][tx] = (pmt::is_f64vector(v) && pmt::length(v) > 0)
+                                 ? pmt::f64vector_ref(v, 0)
+                                 : std::numeric_limits<double>::quiet_NaN();
+
         // Phase Matrix
-        if (pmt::dict_has_key(d_meta, phase_syms[tx]))
+        v = pmt::dict_ref(incoming_meta, harmonia_sdr_key("phase_sdr", tx + 1), pmt::PMT_NIL);
+        if (pmt::is_f64vector(v) && pmt::length(v) > 0)
         {
-          auto v = pmt::dict_ref(d_meta, phase_syms[tx], pmt::PMT_NIL);
-          if (pmt::is_f64vector(v))
-          {
-            auto tmp = pmt::f64vector_elements(v);
-            if (!tmp.empty())
-              phase_matrix[rx][tx] = tmp[0];
-          }
+          phase_matrix[rx][tx] = pmt::f64vector_ref(v, 0);
+          have_phase = true;
         }
+
+        // A link without a detection drops out of the bias / phase solves
+        d_time_active[link_row(tx, rx)] = have_time;
+        d_link_active[link_row(tx, rx)] = have_time && have_phase;
       }
 
       // Check if all values have been received
@@ -209,227 +265,133 @@ namespace gr
       if (!(all_time && all_phase))
         return;
 
-      // AF time and phase matrix
-      af::array m_est = to_af_array(time_matrix);
-      // af_print(m_est);
-      af::array phase_est = to_af_array(phase_matrix);
-      // af_print(phase_est);
-      af::array phase_est_wrap = wrapToPi_af(phase_est);
-
-      // AF TOF and PHI Estimates
-      af::array TOF_est = (m_est + m_est.T()) / 2.0;
-      af::array PHI_est = (m_est - m_est.T()) / 2.0;
-      af::array R_est = TOF_est * 299792458.0;
-
-      // af_print(TOF_est);
-      // af_print(PHI_est);
-
-      //   af::dim4 dims = TOF_est.dims();
-      //   std::vector<double> tof_host(dims.elements());
-      //   std::vector<double> phi_host(dims.elements());
-      //   std::vector<double> m_host(dims.elements());
-
-      //   TOF_est.as(f64).host(tof_host.data());
-      //   PHI_est.as(f64).host(phi_host.data());
-      //   m_est.as(f64).host(m_host.data());
-
-      //  std::cout << std::setprecision(15) << "m_est = \n";
-      //   for (int i = 0; i < dims[0]; ++i)
-      //   {
-      //     for (int j = 0; j < dims[1]; ++j)
-      //     {
-      //       std::cout << m_host[j * dims[0] + i] << " ";
-      //     }
-      //     std::cout << std::endl;
-      //   }
-
-      //   std::cout << std::setprecision(15) << "TOF_est = \n";
-      //   for (int i = 0; i < dims[0]; ++i)
-      //   {
-      //     for (int j = 0; j < dims[1]; ++j)
-      //     {
-      //       std::cout << tof_host[j * dims[0] + i] << " ";
-      //     }
-      //     std::cout << std::endl;
-      //   }
-
-      //   std::cout << std::setprecision(15) << "\nPHI_est = \n";
-      //   for (int i = 0; i < dims[0]; ++i)
-      //   {
-      //     for (int j = 0; j < dims[1]; ++j)
-      //     {
-      //       std::cout << phi_host[j * dims[0] + i] << " ";
-      //     }
-      //     std::cout << std::endl;
-      //   }
+      const int N = num_platforms;
 
       // ================================ CLOCK BIAS ESTIMATION ==================================
+      // TOF = (m + m') / 2 and PHI = (m - m') / 2. Each pair heard in both
+      // directions gives PHI(r, c) = b_r - b_c; the zero-mean WLS solution
+      // of that system is the row mean of PHI when every pair is present,
+      // and the robust estimator can down-weight a bad pair.
       if (bias_status)
       {
-        cb_est = af::sum(PHI_est, 1) / num_platforms;
-        af_print(cb_est);
-
-        af::array nrows = af::iota(af::dim4(num_platforms, 1), af::dim4(1, 1), u32);
-        af::array rowInd = af::tile(nrows, af::dim4(1, num_platforms));
-        af::array ncols = af::iota(af::dim4(1, num_platforms), af::dim4(1, 1), u32);
-        af::array colInd = af::tile(ncols, af::dim4(num_platforms, 1));
-        af::array mask = rowInd > colInd;
-        R_est_lower = R_est(mask);
-        af_print(R_est_lower);
-      }
-      ///////////////////// PRINT /////////////////////////
-      // std::vector<double> host_phi(3);
-      // cb_est.host(host_phi.data());
-      // std::cout << std::fixed << std::setprecision(12)
-      //           << "Clock bias estimates: [";
-      // for (int i = 0; i < N; ++i)
-      // {
-      //   std::cout << host_phi[i]
-      //             << (i + 1 < N ? ", " : "]\n");
-      // }
-      /////////////////////////////////////////////////////
-
-      // =================================== PHASE ESTIMATION ====================================
-      if (phase_status)
-      {
-        af::array gamma = phase_est + (2 * M_PI * center_freq * m_est);
-        af::array gamma_cal_wrap = wrapToPi_af(gamma);
-
-        // Extract off-diagonal entries of gamma_cal_wrap into y_err
-        af::array row_base = af::iota(af::dim4(num_platforms, 1), af::dim4(1, 1), u32);
-        af::array rowIdx = af::tile(row_base, af::dim4(1, num_platforms));
-        af::array col_base = af::iota(af::dim4(1, num_platforms), af::dim4(1, 1), u32);
-        af::array colIdx = af::tile(col_base, af::dim4(num_platforms, 1));
-        af::array mask = rowIdx != colIdx;
-        af::array y_err = gamma_cal_wrap(mask);
-
-        // Append zero to y_err
-        af::array extra_zero = af::constant(0.0, 1, 1, gamma_cal_wrap.type());
-        y_err = af::join(0, y_err, extra_zero);
-        // af_print(y_err);
-
-        // Build A_gamma:
-        int base_rows = num_platforms * (num_platforms - 1);
-        int ntrans = 2 * num_platforms;
-
-        af::array A_gamma = af::constant(0.0, base_rows + 1, ntrans);
-        int ind = 0;
-        for (int jj = 0; jj < num_platforms; ++jj)
+        d_bias_rows.clear();
+        d_bias_w.clear();
+        d_bias_y.clear();
+        d_bias_pair.clear();
+        bool have_var = true;
+        size_t pair = 0;
+        for (int c = 0; c < N; ++c)
         {
-          for (int ii = 0; ii < num_platforms; ++ii)
+          for (int r = c + 1; r < N; ++r, ++pair)
           {
-            if (ii == jj)
+            if (!d_time_active[link_row(c, r)] || !d_time_active[link_row(r, c)])
               continue;
-            A_gamma(ind, jj) = 1.0;
-            A_gamma(ind, num_platforms + ii) = -1.0;
-            ind++;
+            double var = (var_matrix[r][c] + var_matrix[c][r]) / 4.0;
+            have_var = have_var && std::isfinite(var) && var > 0.0;
+            d_bias_rows.push_back({static_cast<size_t>(r), 1.0, static_cast<size_t>(c), -1.0});
+            d_bias_w.push_back(var);
+            d_bias_y.push_back((time_matrix[r][c] - time_matrix[c][r]) / 2.0);
+            d_bias_pair.push_back(pair);
           }
         }
-        // Gamma_TX = 1 Assumption
-        A_gamma(base_rows, 0) = 1.0;
-        // af_print(A_gamma);
-
-        // Solving for Carrier Phases
-        af::array x_est = af::constant(0.0, ntrans, f64);
-        int loops = ntrans / num_platforms;
-        auto twoNonzeroIndices = [&](const af::array &v)
-        {
-          af::array idx = af::where(v != 0);
-          idx = idx.as(s32);
-          int i0 = idx(0).scalar<int>();
-          int i1 = idx(1).scalar<int>();
-          return std::make_pair(i0, i1);
-        };
-
-        // Solving for RX Carrier Phases
-        std::vector<std::pair<int, int>> ind_val_tx(loops);
-        for (int ii = 0; ii < loops; ++ii)
+
+        // Inverse CRLB weights when time_pk_est reported them for every
+        // pair, else equal weights with a purely data-driven robust scale.
+        // The anchor only fixes the common offset (removed below).
+        double w_sum = 0.0;
+        for (double &w : d_bias_w)
         {
-          auto [c0, c1] = twoNonzeroIndices(A_gamma.row(ii));
-          ind_val_tx[ii] = {c0, c1};
-          x_est(num_platforms + ii + 1) = -1.0 * y_err(ii);
+          w = have_var ? 1.0 / w : 1.0;
+          w_sum += w;
         }
+        d_bias_rows.push_back({0, 1.0, 0, 0.0});
+        d_bias_w.push_back(d_bias_pair.empty() ? 1.0 : w_sum / d_bias_pair.size());
+        d_bias_y.push_back(0.0);
 
-        // Solving for TX Carrier Phases
-        for (int ii = 0; ii < loops; ++ii)
+        std::vector<double> cb, resid, weight;
+        if (d_bias_pinv.update(N, d_bias_rows, d_bias_w))
         {
-          int tx_col = ind_val_tx[ii].second;
-          auto [r0, r1] = twoNonzeroIndices(A_gamma.col(tx_col));
-          auto [c0, c1] = twoNonzeroIndices(A_gamma.row(r1));
-          x_est(c0) = y_err(r1) + x_est(tx_col);
+          robust_solve(d_bias_pinv, d_bias_w, d_bias_y, d_bias_pair.size(), d_robust, d_tuning,
+                       cb, resid, weight, have_var ? 1.0 : 0.0);
+          double mean = 0.0;
+          for (double b : cb)
+            mean += b / N;
+          for (int r = 0; r < N; ++r)
+            meta = pmt::dict_add(meta, harmonia_sdr_key("cb_sdr", r + 1), pmt::from_double(cb[r] - mean));
+
+          // Per-pair residual and IRLS weight in the R_sdr pair order
+          const size_t npairs = N * (N - 1) / 2;
+          std::vector<double> pair_resid(npairs, std::numeric_limits<double>::quiet_NaN());
+          std::vector<double> pair_weight(npairs, std::numeric_limits<double>::quiet_NaN());
+          for (size_t k = 0; k < d_bias_pair.size(); ++k)
+          {
+            pair_resid[d_bias_pair[k]] = resid[k];
+            pair_weight[d_bias_pair[k]] = weight[k];
+          }
+          meta = pmt::dict_add(meta, PMT_HARMONIA_BIAS_RESID, pmt::init_f64vector(npairs, pair_resid));
+          meta = pmt::dict_add(meta, PMT_HARMONIA_BIAS_WEIGHT, pmt::init_f64vector(npairs, pair_weight));
+        }
+        else
+        {
+          GR_LOG_WARN(d_logger, "two-way time links do not connect every platform");
         }
 
-        // Solving for RX=1 Carrier Phase
-        auto [r0, r1] = twoNonzeroIndices(A_gamma.col(num_platforms));
-        auto [c0, c1] = twoNonzeroIndices(A_gamma.row(r1));
-        x_est(num_platforms) = -1.0 * (y_err(r1) - x_est(c0));
-        // af_print(x_est);
-
-        // Compute y_est = A_gamma * x_est
-        af::array y_est = af::matmul(A_gamma.as(f64), x_est);
-
-        // Compute gamma_wrap
-        af::array y_est_d = y_est.as(f64);
-        af::array y_err_d = y_err.as(f64);
-        af::array diff = (y_est_d - y_err_d) / (2.0 * M_PI);
-        af::array rounded = af::round(diff);
-        af::array gamma_wrap = rounded * (2.0 * M_PI);
-
-        // Compute variance matrix
-        double var_f = 3.0 /
-                       (2.0 * std::pow(af::Pi, 2.0) *
-                        std::pow(pulse_width, 3.0) *
-                        samp_rate *
-                        std::pow(10.0, (SNR / 10.0)) *
-                        (1.0 - std::pow(1.0 / (pulse_width * samp_rate), 2.0)));
-
-        af::array diag_vals = af::join(
-            0,
-            af::constant(var_f, 2.0 * num_platforms, f64),
-            af::constant(1e-12, 1.0, f64));
-        af::array C_err = af::diag(diag_vals, 0, false);
-
-        // Cast A_gamma to double
-        af::array A_gamma_d = A_gamma.as(f64);
-
-        // Solve the system
-        af::array Cinv = af::inverse(C_err);
-        af::array At_Cinv = af::matmul(A_gamma_d.T(), Cinv);
-        af::array mid = af::matmul(At_Cinv, A_gamma_d);
-        af::array inv_mid = af::inverse(mid);
-        af::array rhs = af::matmul(At_Cinv, (y_err_d + gamma_wrap));
-        af::array x_gamma = af::matmul(inv_mid, rhs);
-        x_gamma_est = wrapToPi_af(x_gamma);
-        af_print(x_gamma_est);
-      }
-
-      // =================================== OUTPUT ESTIMATES ====================================
-      if (bias_status)
-      {
-        std::vector<double> x_host(cb_est.elements());
-        cb_est.host(x_host.data());
-        std::vector<double> R_host(R_est_lower.elements());
-        R_est_lower.host(R_host.data());
-
-        meta = pmt::dict_add(meta, PMT_HARMONIA_CB_SDR1, pmt::from_double(x_host[0]));
-        meta = pmt::dict_add(meta, PMT_HARMONIA_CB_SDR2, pmt::from_double(x_host[1]));
-        meta = pmt::dict_add(meta, PMT_HARMONIA_CB_SDR3, pmt::from_double(x_host[2]));
-        meta = pmt::dict_add(meta, PMT_HARMONIA_R_SDR12, pmt::from_double(R_host[0]));
-        meta = pmt::dict_add(meta, PMT_HARMONIA_R_SDR13, pmt::from_double(R_host[1]));
-        meta = pmt::dict_add(meta, PMT_HARMONIA_R_SDR23, pmt::from_double(R_host[2]));
+        // Lower triangle in column-major order: (2,1), (3,1), (3,2), ...
+        for (int c = 0; c < N; ++c)
+        {
+          for (int r = c + 1; r < N; ++r)
+          {
+            double tof = (time_matrix[r][c] + time_matrix[c][r]) / 2.0;
+            pmt::pmt_t key = pmt::intern("R_sdr" + std::to_string(c + 1) + std::to_string(r + 1));
+            meta = pmt::dict_add(meta, key, pmt::from_double(tof * 299792458.0));
+          }
+        }
         meta = pmt::dict_add(meta, pmt::intern("clock_bias_enable"), pmt::PMT_T);
       }
 
-      if (phase_status)
+      // =================================== PHASE ESTIMATION ====================================
+      if (phase_status && !update_phase_solver())
+        GR_LOG_WARN(d_logger, "active phase links do not connect every platform");
+      else if (phase_status)
       {
-        std::vector<double> x_gamma_host(x_gamma_est.elements());
-        x_gamma_est.host(x_gamma_host.data());
-        meta = pmt::dict_add(meta, PMT_HARMONIA_CP_TX_SDR1, pmt::from_double(x_gamma_host[0]));
-        meta = pmt::dict_add(meta, PMT_HARMONIA_CP_TX_SDR2, pmt::from_double(x_gamma_host[1]));
-        meta = pmt::dict_add(meta, PMT_HARMONIA_CP_TX_SDR3, pmt::from_double(x_gamma_host[2]));
-        meta = pmt::dict_add(meta, PMT_HARMONIA_CP_RX_SDR1, pmt::from_double(x_gamma_host[3]));
-        meta = pmt::dict_add(meta, PMT_HARMONIA_CP_RX_SDR2, pmt::from_double(x_gamma_host[4]));
-        meta = pmt::dict_add(meta, PMT_HARMONIA_CP_RX_SDR3, pmt::from_double(x_gamma_host[5]));
+        const int ntrans = 2 * N;
+
+        // Calibrated link phases, in active row order, plus the anchor
+        const size_t rows = d_phase_rows.size();
+        std::vector<double> y(rows, 0.0);
+        for (size_t r = 0; r + 1 < rows; ++r)
+        {
+          int tx = d_phase_links[d_phase_active[r]].first;
+          int rx_i = d_phase_links[d_phase_active[r]].second;
+          y[r] = wrap_to_pi(phase_matrix[rx_i][tx] + 2.0 * M_PI * center_freq * time_matrix[rx_i][tx]);
+        }
+
+        // Initial solution along the spanning tree (anchor t_0 = 0)
+        std::vector<double> x0(ntrans, 0.0);
+        for (const auto &e : d_phase_tree)
+        {
+          if (e.to >= N)
+            x0[e.to] = x0[e.from] - y[e.row]; // r = t - y
+          else
+            x0[e.to] = y[e.row] + x0[e.from]; // t = y + r
+        }
+
+        // Resolve each row's 2*pi ambiguity against the tree solution,
+        // then one weighted LS through the cached pseudo-inverse
+        for (size_t r = 0; r < rows; ++r)
+        {
+          const wls_row &a = d_phase_rows[r];
+          double y_est = a.a0 * x0[a.c0] + a.a1 * x0[a.c1];
+          y[r] += 2.0 * M_PI * std::round((y_est - y[r]) / (2.0 * M_PI));
+        }
+        std::vector<double> x_gamma;
+        d_phase_pinv.apply(y, x_gamma);
+
+        for (int k = 0; k < N; ++k)
+        {
+          meta = pmt::dict_add(meta, harmonia_sdr_key("cp_tx_sdr", k + 1), pmt::from_double(wrap_to_pi(x_gamma[k])));
+          meta = pmt::dict_add(meta, harmonia_sdr_key("cp_rx_sdr", k + 1), pmt::from_double(wrap_to_pi(x_gamma[N + k])));
+        }
         meta = pmt::dict_add(meta, pmt::intern("carrier_phase_enable"), pmt::PMT_T);
       }
 
@@ -10,9 +10,14 @@
 
 #include <gnuradio/harmonia/clockbias_phase_est.h>
 #include <gnuradio/harmonia/pmt_constants.h>
-#include <arrayfire.h>
+#include "wls.h"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iomanip>
+#include <limits>
+#include <utility>
+#include <vector>
 
 namespace gr
 {
@@ -33,23 +38,56 @@ namespace gr
       // Variables
       std::vector<std::vector<double>> time_matrix;
       std::vector<std::vector<double>> phase_matrix;
+      std::vector<std::vector<double>> var_matrix;
       std::vector<bool> check_time;
       std::vector<bool> check_phase;
-      double alpha1, alpha2, alpha3;
-      af::array TOF_est, Phase_est;
-      af::array cb_est, x_gamma_est, R_est_lower;
-      
+      std::vector<double> d_alpha;
+
+      // Phase resolution: (tx, rx) of every possible link row and whether
+      // it has a detection; the rows, spanning-tree walk and weighted
+      // pseudo-inverse of the active set are cached until that set changes
+      struct tree_edge
+      {
+        int row, from, to;
+      };
+      std::vector<std::pair<int, int>> d_phase_links;
+      std::vector<bool> d_link_active;
+      std::vector<bool> d_time_active;
+      std::vector<size_t> d_phase_active;
+      std::vector<wls_row> d_phase_rows;
+      std::vector<tree_edge> d_phase_tree;
+      wls_pinv d_phase_pinv;
+      double d_phase_w;
+      bool d_phase_ok;
+
+      // Bias solve over two-way pairs: rows, weights, observations, pair
+      // index (R_sdr order) per row, and the cached pseudo-inverse
+      std::vector<wls_row> d_bias_rows;
+      std::vector<double> d_bias_w;
+      std::vector<double> d_bias_y;
+      std::vector<size_t> d_bias_pair;
+      wls_pinv d_bias_pinv;
+
+      // Robust estimator
+      robust_kind d_robust;
+      double d_tuning;
+
       // Object and data
       pmt::pmt_t d_data;
 
       // Metadata fields
       pmt::pmt_t meta;
       pmt::pmt_t key;
-      pmt::pmt_t d_meta = pmt::make_dict();
       pmt::pmt_t cd_meta = pmt::make_dict();
 
       // Functions
-      af::array to_af_array(const std::vector<std::vector<double>> &matrix);
+      bool update_phase_solver();
+
+      // Row of link (tx, rx) in d_phase_links (0-based, tx-major)
+      size_t link_row(int tx, int rx) const
+      {
+        return tx * (num_platforms - 1) + (rx < tx ? rx : rx - 1);
+      }
       void handle_msg(pmt::pmt_t msg);
       void handle_clock_drift(pmt::pmt_t msg);
 
@@ -62,6 +100,8 @@ namespace gr
                                bool bias_status,
                                bool phase_status);
       ~clockbias_phase_est_impl();
+
+      void set_robust_estimator(const std::string &kind, double tuning) override;
     };
 
   } // namespace harmonia
@@ -27,7 +27,9 @@ namespace gr
                     gr::io_signature::make(0, 0, 0)),
           center_freq(center_freq),
           samp_rate(samp_rate),
-          sdr_id(sdr_id)
+          sdr_id(sdr_id),
+          t_delay(0.0),
+          d_delay_method(delay_method::FFT)
     {
 
       message_port_register_in(PMT_HARMONIA_IN);
@@ -50,6 +52,28 @@ namespace gr
      */
     compensation_impl::~compensation_impl() {}
 
+    void compensation_impl::set_delay_method(const std::string &method, int taps)
+    {
+      d_delay_method = delay_method_from_string(method);
+      if (d_delay_method == delay_method::FIR && (!d_fir || d_fir->taps() != taps))
+        d_fir.reset(new fractional_delay(taps));
+    }
+
+    const af::array &compensation_impl::freq_axis(size_t len)
+    {
+      auto it = d_freq_cache.find(len);
+      if (it != d_freq_cache.end())
+        return it->second;
+
+      // Frequency of each unshifted FFT bin: bin k sits at position
+      // (k + len/2) mod len of the fftshifted axis -fs/2 + i*fs/len
+      std::vector<float> f(len);
+      for (size_t k = 0; k < len; ++k)
+        f[k] = static_cast<float>(-samp_rate / 2.0 + ((k + len / 2) % len) * (samp_rate / len));
+
+      return d_freq_cache.emplace(len, af::array(len, f.data())).first->second;
+    }
+
     void compensation_impl::handle_cd_msg(pmt::pmt_t msg)
     {
       // Validate message is a PDU
@@ -131,7 +155,6 @@ namespace gr
       // Convert Data into AF vector
       size_t len = 0;
       const gr_complex *in_ptr = pmt::c32vector_elements(samples, len);
-      af::array af_input = af::array(len, reinterpret_cast<const af::cfloat *>(in_ptr));
 
       if (len == 0 || !in_ptr)
       {
@@ -165,35 +188,64 @@ namespace gr
       else
         gamma_hat = 0.0;
 
-      // FFT-base Fractional Delay
-      af::array X = af::fft(af_input, len);
-      X = ::plasma::fftshift(X, 0);
-      af::array f = (-samp_rate / 2.0) + ((af::seq(0, len - 1)) * (samp_rate / len));
-      af::array X_delay = X * af::exp(1.0 * af::Im * 2.0 * M_PI * f * (t_delay));
-      X_delay = ::plasma::ifftshift(X_delay, 0);
-      af::array x_delay = af::ifft(X_delay);
-
-      // Output Data
-      pmt::pmt_t vec = pmt::make_c32vector(len, gr_complex{0, 0});
-      gr_complex *out_ptr = pmt::c32vector_writable_elements(vec, len);
-      x_delay.host(reinterpret_cast<af::cfloat *>(out_ptr));
-
-      // Phase adjustment variables
-      std::vector<gr_complex> host(len);
+      // Phase terms: the constant part 2*pi*fc*phi + gamma is a scalar and
+      // on the FFT path is applied together with the delay ramp in the
+      // frequency domain. Only the drift part, 2*pi*fc*(alpha - 1) * n*Ts /
+      // alpha, varies with time and is left for the time-domain rotator.
       const double constant = 2.0 * M_PI * center_freq;
       const double Ts = 1.0 / samp_rate;
+      const double phase0 = std::remainder(constant * phi_hat + gamma_hat, 2.0 * M_PI);
+      const double phase_inc = std::remainder(constant * (alpha_hat - 1.0) * Ts / alpha_hat, 2.0 * M_PI);
 
-      // Phase adjusting signal
-      for (size_t n = 0; n < len; ++n)
+      pmt::pmt_t out_vec = pmt::make_c32vector(len, gr_complex{0, 0});
+      gr_complex *out_ptr = pmt::c32vector_writable_elements(out_vec, len);
+
+      if (d_delay_method == delay_method::FIR)
+      {
+        // Polyphase FIR on the host: the ramp exp(j*2*pi*f*t_delay)
+        // advances the capture by t_delay, i.e. a delay of -t_delay*fs
+        // samples. Both phase terms then go through the rotator.
+        if (phase0 == 0.0 && phase_inc == 0.0)
+        {
+          d_fir->apply(in_ptr, out_ptr, len, -t_delay * samp_rate);
+        }
+        else
+        {
+          d_scratch.resize(len);
+          d_fir->apply(in_ptr, d_scratch.data(), len, -t_delay * samp_rate);
+          d_rotator.set_phase(std::polar(1.0f, static_cast<float>(phase0)));
+          d_rotator.set_phase_incr(std::polar(1.0f, static_cast<float>(phase_inc)));
+          d_rotator.rotateN(out_ptr, d_scratch.data(), len);
+        }
+        message_port_pub(PMT_HARMONIA_OUT, pmt::cons(meta, out_vec));
+        return;
+      }
+
+      // FFT-based fractional delay fused with the constant phase: one
+      // elementwise pass over the unshifted spectrum (the fftshift pair is
+      // folded into the cached frequency axis)
+      af::array af_input = af::array(len, reinterpret_cast<const af::cfloat *>(in_ptr));
+      const af::array &f = freq_axis(len);
+      af::array ramp = (2.0 * M_PI * t_delay) * f + phase0;
+      af::array x_delay = af::ifft(af::fft(af_input, len) * af::complex(af::cos(ramp), af::sin(ramp)));
+
+      if (phase_inc == 0.0)
+      {
+        // No drift: download straight into the output PDU
+        x_delay.host(reinterpret_cast<af::cfloat *>(out_ptr));
+      }
+      else
       {
-        double tau = n * Ts;
-        double phase = constant * ((alpha_hat - 1.0) * tau/alpha_hat + phi_hat) + gamma_hat;
-        std::complex<float> phcorr = std::exp(std::complex<float>(0.0, float(phase)));
-        host[n] = out_ptr[n] * phcorr;
+        // Drift ramp as a rotator (complex NCO recurrence, renormalised
+        // internally) writing into the output PDU
+        d_scratch.resize(len);
+        x_delay.host(reinterpret_cast<af::cfloat *>(d_scratch.data()));
+        d_rotator.set_phase(gr_complex(1.0f, 0.0f));
+        d_rotator.set_phase_incr(std::polar(1.0f, static_cast<float>(phase_inc)));
+        d_rotator.rotateN(out_ptr, d_scratch.data(), len);
       }
 
       // Export data
-      pmt::pmt_t out_vec = pmt::init_c32vector(len, host.data());
       message_port_pub(PMT_HARMONIA_OUT, pmt::cons(meta, out_vec));
     }
 
@@ -10,9 +10,14 @@
 
 #include <gnuradio/harmonia/compensation.h>
 #include <gnuradio/harmonia/pmt_constants.h>
+#include <gnuradio/blocks/rotator.h>
+#include "fractional_delay.h"
 #include <arrayfire.h>
 #include <plasma_dsp/pulsed_waveform.h>
 #include <plasma_dsp/fft.h>
+#include <map>
+#include <memory>
+#include <vector>
 
 namespace gr
 {
@@ -38,10 +43,22 @@ namespace gr
       double alpha_hat, phi_hat, gamma_hat;
       double t_delay;
 
+      // Phase correction NCO and capture scratch buffer
+      gr::blocks::rotator d_rotator;
+      std::vector<gr_complex> d_scratch;
+
+      // Unshifted FFT frequency axis per capture length
+      std::map<size_t, af::array> d_freq_cache;
+
+      // Delay method and polyphase filter for the FIR path
+      delay_method d_delay_method;
+      std::unique_ptr<fractional_delay> d_fir;
+
       // Metadata
       pmt::pmt_t d_meta;
       pmt::pmt_t d_data;
 
+      const af::array &freq_axis(size_t len);
       void handle_msg(pmt::pmt_t);
       void handle_cd_msg(pmt::pmt_t);
       void handle_cb_msg(pmt::pmt_t);
@@ -50,6 +67,8 @@ namespace gr
     public:
       compensation_impl(double center_freq, double samp_rate, int sdr_id);
       ~compensation_impl();
+
+      void set_delay_method(const std::string &method, int taps) override;
     };
 
   } // namespace harmonia
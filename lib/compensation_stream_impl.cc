@@ -0,0 +1,181 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "compensation_stream_impl.h"
+#include <gnuradio/io_signature.h>
+#include <algorithm>
+#include <cmath>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    compensation_stream::sptr compensation_stream::make(double center_freq, double samp_rate,
+                                                        int sdr_id, int taps, int max_delay)
+    {
+      return gnuradio::make_block_sptr<compensation_stream_impl>(center_freq, samp_rate, sdr_id,
+                                                                 taps, max_delay);
+    }
+
+    /*
+     * The private constructor
+     */
+    compensation_stream_impl::compensation_stream_impl(double center_freq, double samp_rate,
+                                                       int sdr_id, int taps, int max_delay)
+        : gr::sync_block("compensation_stream",
+                         gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                         gr::io_signature::make(1, 1, sizeof(gr_complex))),
+          center_freq(center_freq),
+          samp_rate(samp_rate),
+          sdr_id(sdr_id),
+          d_max_delay(std::max(max_delay, 0)),
+          d_latency(d_max_delay + taps / 2),
+          d_fir(taps)
+    {
+      // Enough history for any delay in [-max_delay, max_delay] on top of
+      // the fixed latency, so the filter never reads past the input
+      set_history(2 * d_max_delay + taps + 1);
+
+      message_port_register_in(PMT_HARMONIA_CD_IN);
+      message_port_register_in(PMT_HARMONIA_CB_IN);
+      message_port_register_in(PMT_HARMONIA_CP_IN);
+      set_msg_handler(PMT_HARMONIA_CD_IN, [this](pmt::pmt_t msg)
+                      { handle_cd_msg(msg); });
+      set_msg_handler(PMT_HARMONIA_CB_IN, [this](pmt::pmt_t msg)
+                      { handle_cb_msg(msg); });
+      set_msg_handler(PMT_HARMONIA_CP_IN, [this](pmt::pmt_t msg)
+                      { handle_cp_msg(msg); });
+    }
+
+    /*
+     * Our virtual destructor.
+     */
+    compensation_stream_impl::~compensation_stream_impl() {}
+
+    void compensation_stream_impl::set_delay(double t_delay)
+    {
+      gr::thread::scoped_lock lock(d_mutex);
+      d_t_delay = t_delay;
+    }
+
+    void compensation_stream_impl::handle_cd_msg(pmt::pmt_t msg)
+    {
+      // Validate message is a PDU
+      if (!pmt::is_pair(msg))
+      {
+        GR_LOG_ERROR(d_logger, "Expected message to be a PDU");
+        return;
+      }
+
+      // Keys missing from the message leave the current estimate in place
+      gr::thread::scoped_lock lock(d_mutex);
+      d_alpha = pmt::to_double(pmt::dict_ref(msg, harmonia_sdr_key("sdr", sdr_id), pmt::from_double(d_alpha)));
+    }
+
+    void compensation_stream_impl::handle_cb_msg(pmt::pmt_t msg)
+    {
+      // Validate message is a PDU
+      if (!pmt::is_pair(msg))
+      {
+        GR_LOG_ERROR(d_logger, "Expected message to be a PDU");
+        return;
+      }
+
+      gr::thread::scoped_lock lock(d_mutex);
+      d_phi = pmt::to_double(pmt::dict_ref(msg, harmonia_sdr_key("cb_sdr", sdr_id), pmt::from_double(d_phi)));
+    }
+
+    void compensation_stream_impl::handle_cp_msg(pmt::pmt_t msg)
+    {
+      // Validate message is a PDU
+      if (!pmt::is_pair(msg))
+      {
+        GR_LOG_ERROR(d_logger, "Expected message to be a PDU");
+        return;
+      }
+
+      gr::thread::scoped_lock lock(d_mutex);
+      d_gamma = pmt::to_double(pmt::dict_ref(msg, harmonia_sdr_key("cp_rx_sdr", sdr_id), pmt::from_double(d_gamma)));
+    }
+
+    void compensation_stream_impl::filter(const gr_complex *in, gr_complex *out,
+                                          int start, int len, double t_delay)
+    {
+      // As in compensation, t_delay advances the signal: a delay of
+      // -t_delay * fs samples, clamped to the history, plus the latency
+      const double d = std::min(std::max(-t_delay * samp_rate, -static_cast<double>(d_max_delay)),
+                                static_cast<double>(d_max_delay));
+      d_fir.set_delay(d + d_latency);
+
+      // in[history() - 1 + j] is the sample aligned with out[j]
+      const long offset = static_cast<long>(history()) - 1 - d_fir.integer_delay() - d_fir.taps() / 2;
+      d_fir.filter(in + start + offset, out + start, len);
+    }
+
+    int compensation_stream_impl::work(int noutput_items,
+                                       gr_vector_const_void_star &input_items,
+                                       gr_vector_void_star &output_items)
+    {
+      const gr_complex *in = static_cast<const gr_complex *>(input_items[0]);
+      gr_complex *out = static_cast<gr_complex *>(output_items[0]);
+
+      // Latch the estimates once per call so a message never lands halfway
+      // through the phase or delay of a buffer
+      double alpha, phi, gamma, t_delay;
+      {
+        gr::thread::scoped_lock lock(d_mutex);
+        alpha = d_alpha;
+        phi = d_phi;
+        gamma = d_gamma;
+        t_delay = d_t_delay;
+      }
+
+      // rx_error tags change the delay from the tagged sample onwards
+      std::vector<gr::tag_t> tags;
+      get_tags_in_window(tags, 0, 0, noutput_items, PMT_HARMONIA_RX_ERROR);
+      std::sort(tags.begin(), tags.end(), gr::tag_t::offset_compare);
+
+      int start = 0;
+      for (const gr::tag_t &tag : tags)
+      {
+        if (!pmt::is_real(tag.value))
+          continue;
+        const int pos = static_cast<int>(tag.offset - nitems_read(0));
+        if (pos > start)
+        {
+          filter(in, out, start, pos - start, t_delay);
+          start = pos;
+        }
+        t_delay = pmt::to_double(tag.value);
+      }
+      filter(in, out, start, noutput_items - start, t_delay);
+
+      if (!tags.empty())
+      {
+        gr::thread::scoped_lock lock(d_mutex);
+        d_t_delay = t_delay;
+      }
+
+      // Phase: constant 2*pi*fc*phi + gamma plus the drift ramp
+      // 2*pi*fc*(alpha - 1) * n*Ts / alpha, with n counted from the start
+      // of the stream via the accumulator (kept in double, wrapped)
+      const double constant = 2.0 * M_PI * center_freq;
+      const double phase0 = constant * phi + gamma;
+      const double phase_inc = std::remainder(constant * (alpha - 1.0) / (alpha * samp_rate), 2.0 * M_PI);
+
+      d_rotator.set_phase(std::polar(1.0f, static_cast<float>(std::remainder(phase0 + d_acc, 2.0 * M_PI))));
+      d_rotator.set_phase_incr(std::polar(1.0f, static_cast<float>(phase_inc)));
+      d_rotator.rotateN(out, out, noutput_items);
+      d_acc = std::remainder(d_acc + phase_inc * noutput_items, 2.0 * M_PI);
+
+      // Tell runtime system how many output items we produced.
+      return noutput_items;
+    }
+
+  } /* namespace harmonia */
+} /* namespace gr */
@@ -0,0 +1,65 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_HARMONIA_COMPENSATION_STREAM_IMPL_H
+#define INCLUDED_HARMONIA_COMPENSATION_STREAM_IMPL_H
+
+#include <gnuradio/harmonia/compensation_stream.h>
+#include <gnuradio/harmonia/pmt_constants.h>
+#include <gnuradio/blocks/rotator.h>
+#include "fractional_delay.h"
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    class compensation_stream_impl : public compensation_stream
+    {
+    private:
+      // Parameters
+      double center_freq;
+      double samp_rate;
+      int sdr_id;
+      int d_max_delay;
+      double d_latency; // fixed output latency (samples)
+
+      // Latest estimates, written by the message handlers and latched by
+      // work() under d_mutex
+      gr::thread::mutex d_mutex;
+      double d_alpha = 1.0;
+      double d_phi = 0.0;
+      double d_gamma = 0.0;
+      double d_t_delay = 0.0;
+
+      // Drift phase accumulated over all samples produced so far (rad)
+      double d_acc = 0.0;
+
+      gr::blocks::rotator d_rotator;
+      fractional_delay d_fir;
+
+      void handle_cd_msg(pmt::pmt_t msg);
+      void handle_cb_msg(pmt::pmt_t msg);
+      void handle_cp_msg(pmt::pmt_t msg);
+      void filter(const gr_complex *in, gr_complex *out, int start, int len, double t_delay);
+
+    public:
+      compensation_stream_impl(double center_freq, double samp_rate, int sdr_id,
+                               int taps, int max_delay);
+      ~compensation_stream_impl();
+
+      void set_delay(double t_delay) override;
+
+      int work(int noutput_items,
+               gr_vector_const_void_star &input_items,
+               gr_vector_void_star &output_items) override;
+    };
+
+  } // namespace harmonia
+} // namespace gr
+
+#endif /* INCLUDED_HARMONIA_COMPENSATION_STREAM_IMPL_H */
@@ -0,0 +1,134 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "fractional_delay.h"
+#include <volk/volk.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    delay_method delay_method_from_string(const std::string &method)
+    {
+      if (method == "fir")
+        return delay_method::FIR;
+      if (method == "fft")
+        return delay_method::FFT;
+      throw std::invalid_argument("unknown fractional delay method: " + method);
+    }
+
+    // Zeroth-order modified Bessel function of the first kind (series)
+    static double bessel_i0(double x)
+    {
+      double sum = 1.0, term = 1.0;
+      for (int k = 1; k < 50; k++)
+      {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < 1e-12 * sum)
+          break;
+      }
+      return sum;
+    }
+
+    // Validated before the tables are sized from them
+    static int checked_taps(int taps, int phases)
+    {
+      if (taps < 2 || (taps % 2) != 0 || phases < 1)
+        throw std::invalid_argument("fractional_delay needs an even number of taps >= 2");
+      return taps;
+    }
+
+    fractional_delay::fractional_delay(int taps, int phases)
+        : d_taps(checked_taps(taps, phases)),
+          d_phases(phases),
+          d_table((phases + 1) * taps),
+          d_g(taps),
+          d_int(0)
+    {
+      // h_mu[t] = sinc(x) * kaiser(x), x = t - (taps/2 - 1) - mu, stored
+      // reversed so the filter is a forward dot product over the input
+      const double beta = 8.0;
+      const double half = taps / 2.0;
+      const double i0_beta = bessel_i0(beta);
+      for (int p = 0; p <= phases; p++)
+      {
+        const double mu = static_cast<double>(p) / phases;
+        float *h = &d_table[p * taps];
+        for (int t = 0; t < taps; t++)
+        {
+          const double x = t - (half - 1.0) - mu;
+          const double px = M_PI * x;
+          const double s = (x == 0.0) ? 1.0 : std::sin(px) / px;
+          const double r = x / half;
+          const double w = (std::abs(r) < 1.0) ? bessel_i0(beta * std::sqrt(1.0 - r * r)) / i0_beta : 0.0;
+          h[taps - 1 - t] = static_cast<float>(s * w);
+        }
+      }
+      set_delay(0.0);
+    }
+
+    void fractional_delay::set_delay(double delay)
+    {
+      const double k = std::floor(delay);
+      const double pos = (delay - k) * d_phases;
+      int p = static_cast<int>(pos);
+      p = std::min(std::max(p, 0), d_phases - 1);
+      const float a = static_cast<float>(pos - p);
+
+      d_int = static_cast<long>(k);
+      const float *h0 = &d_table[p * d_taps];
+      const float *h1 = h0 + d_taps;
+      for (int t = 0; t < d_taps; t++)
+        d_g[t] = (1.0f - a) * h0[t] + a * h1[t];
+    }
+
+    void fractional_delay::filter(const gr_complex *in, gr_complex *out, size_t n) const
+    {
+      for (size_t j = 0; j < n; j++)
+        volk_32fc_32f_dot_prod_32fc(&out[j], &in[j], d_g.data(), d_taps);
+    }
+
+    void fractional_delay::apply(const gr_complex *in, gr_complex *out, size_t n, double delay)
+    {
+      if (std::isnan(delay))
+      {
+        std::fill(out, out + n, gr_complex(0.0f, 0.0f));
+        return;
+      }
+
+      // Past n + taps samples either way the output is all zeros; the clamp
+      // keeps the integer part and the padding bounded
+      const double max_delay = static_cast<double>(n) + d_taps;
+      set_delay(std::min(std::max(delay, -max_delay), max_delay));
+
+      // y[m] reads x[m - k - taps/2 + i], i < taps. Lay x out in a zeroed
+      // buffer so every window is in range; pad[j] = x[j - offset].
+      const long lead = d_int + d_taps / 2;
+      const long offset = std::max(lead, 0L);
+      const long tail = std::max(static_cast<long>(d_taps) - lead, 0L);
+      d_pad.assign(n + offset + tail, gr_complex(0.0f, 0.0f));
+      std::copy(in, in + n, d_pad.begin() + offset);
+
+      // Windows starting before pad[0] or after its end only see zeros
+      const long start = offset - lead; // pad index of y[0]'s window
+      for (size_t m = 0; m < n; m++)
+      {
+        const long s = start + static_cast<long>(m);
+        if (s < 0 || s + d_taps > static_cast<long>(d_pad.size()))
+          out[m] = gr_complex(0.0f, 0.0f);
+        else
+          volk_32fc_32f_dot_prod_32fc(&out[m], &d_pad[s], d_g.data(), d_taps);
+      }
+    }
+
+  } // namespace harmonia
+} // namespace gr
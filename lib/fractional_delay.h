@@ -0,0 +1,80 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_HARMONIA_FRACTIONAL_DELAY_H
+#define INCLUDED_HARMONIA_FRACTIONAL_DELAY_H
+
+#include <gnuradio/gr_complex.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    /*
+     * Delay methods selectable on the blocks that time-align captures:
+     * FFT applies an exact (circular) linear-phase ramp over the whole
+     * capture; FIR uses the polyphase windowed-sinc filter below, which is
+     * O(N * taps), linear rather than circular, and works on streams.
+     */
+    enum class delay_method
+    {
+      FFT,
+      FIR
+    };
+
+    delay_method delay_method_from_string(const std::string &method);
+
+    /*
+     * Polyphase windowed-sinc fractional delay.
+     *
+     * The coefficient table holds `phases + 1` Kaiser-windowed sinc filters
+     * of `taps` taps for fractional offsets 0, 1/phases, ..., 1; a delay
+     * interpolates linearly between the two nearest phases (first-order
+     * Farrow), so arbitrary delays cost `taps` multiplies to set up. The
+     * filter itself is one VOLK complex-by-real dot product per output.
+     */
+    class fractional_delay
+    {
+    public:
+      explicit fractional_delay(int taps = 16, int phases = 512);
+
+      int taps() const { return d_taps; }
+
+      // Select a delay in samples (any sign, may be non-integer):
+      // y[n] = x(n - delay)
+      void set_delay(double delay);
+
+      // Integer part of the delay selected by set_delay()
+      long integer_delay() const { return d_int; }
+
+      // Streaming form: out[j] = sum_i g[i] * in[j + i] for j < n, reading
+      // n + taps - 1 inputs. With in[j] = x[m + j - integer_delay() -
+      // taps/2], out[j] is y[m + j].
+      void filter(const gr_complex *in, gr_complex *out, size_t n) const;
+
+      // Whole-capture form: delay n samples by `delay`, treating samples
+      // outside the capture as zero (so is the output for a NaN delay).
+      // in and out must not alias.
+      void apply(const gr_complex *in, gr_complex *out, size_t n, double delay);
+
+    private:
+      int d_taps;
+      int d_phases;
+      std::vector<float> d_table; // (phases + 1) x taps, reversed per phase
+      std::vector<float> d_g;     // taps for the current delay
+      long d_int;
+      std::vector<gr_complex> d_pad;
+    };
+
+  } // namespace harmonia
+} // namespace gr
+
+#endif /* INCLUDED_HARMONIA_FRACTIONAL_DELAY_H */
@@ -6,10 +6,13 @@
  */
 
 #include "frequency_pk_est_impl.h"
+#include "sinc_nlls.h"
 #include <gnuradio/io_signature.h>
 #include <arrayfire.h>
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
+#include <limits>
 
 namespace gr
 {
@@ -48,6 +51,8 @@ namespace gr
               NLLS_iter(NLLS_iter),
               sdr_id(sdr_id),
               enable_out(enable_out),
+              d_num_pulses(1),
+              d_coherent(true),
               d_rx_count(0)
         {
             d_in_port = PMT_HARMONIA_IN;
@@ -64,6 +69,8 @@ namespace gr
             message_port_register_out(d_f_out_port);
             set_msg_handler(d_in_port, [this](pmt::pmt_t msg)
                             { handle_msg(msg); });
+
+            set_spectral_params(cap_length, pulse_width);
         }
 
         /*
@@ -71,10 +78,307 @@ namespace gr
          */
         frequency_pk_est_impl::~frequency_pk_est_impl() {}
 
-        // Sinc Function
-        af::array frequency_pk_est_impl::sinc(const af::array &x)
+        void frequency_pk_est_impl::set_spectral_params(double cap, double width)
+        {
+            // Number of NLLS points: at least 5, odd so the window is centred
+            // on the peak bin, and within the solver's fixed-size range
+            double NLLS_pts = std::ceil(fft_ratio * 2.0 * width / cap) - 1.0;
+            d_nlls_pts = static_cast<size_t>(std::max(NLLS_pts, 5.0));
+            d_nlls_pts |= 1;
+            d_nlls_pts = std::min<size_t>(d_nlls_pts, 31);
+            d_nlls_y.resize(d_nlls_pts);
+
+            // Half-width of the spectral mainlobe (first null) in FFT bins
+            d_mainlobe_half = static_cast<int>(std::ceil(fft_ratio * cap / width));
+            d_cap = cap;
+            d_width = width;
+        }
+
+        void frequency_pk_est_impl::full_spectrum(const af::array &af_input, size_t n, spectrum_peak &pk)
+        {
+            double NFFT = fft_ratio * n;
+
+            // FFT
+            af::array af_fft = af::fft(af_input, NFFT);
+
+            // FFTshift to zero
+            af_fft = ::plasma::fftshift(af_fft, 0);
+            spectrum_peak_search(af::abs(af_fft), pk);
+        }
+
+        void frequency_pk_est_impl::integrated_spectrum(const af::array &af_input, size_t n, spectrum_peak &pk)
+        {
+            // Split the capture into M pulse repetition intervals of L samples
+            // (dropping any remainder) and transform all of them at once. The
+            // bin spacing is fs / (fft_ratio L), M times coarser than the
+            // whole-capture FFT
+            dim_t M = d_num_pulses;
+            dim_t L = n / M;
+            double NFFT = fft_ratio * L;
+            af::array pulses = af::moddims(af_input(af::seq(0, M * L - 1)), L, M);
+            af::array spec = af::fft(pulses, NFFT);
+
+            // RMS of the magnitudes, which keeps the sinc shape for the NLLS
+            // fit. Only non-coherent: every block restarts at index 0, so the
+            // complex spectra carry a tone-dependent phase per block
+            af::array integrated = af::sqrt(af::sum(af::pow(af::abs(spec), 2), 1));
+
+            spectrum_peak_search(::plasma::fftshift(integrated, 0), pk);
+        }
+
+        void frequency_pk_est_impl::spectrum_peak_search(const af::array &af_abs_fft, spectrum_peak &pk)
+        {
+            const dim_t nfft = af_abs_fft.elements();
+
+            // Output absolute fft of input data, only when it is published
+            if (enable_out)
+            {
+                size_t io(0);
+                d_data = pmt::make_f32vector(nfft, 0);
+                af_abs_fft.host(pmt::f32vector_writable_elements(d_data, io));
+                message_port_pub(d_out_port, pmt::cons(d_meta, d_data));
+            }
+
+            // Peak search and link quality reductions on the device: noise
+            // floor and strongest sidelobe outside the peak's mainlobe
+            af::array max_arr, idx_arr;
+            af::max(max_arr, idx_arr, af_abs_fft, 0);
+            af::array bins = af::range(af::dim4(nfft), 0, s32);
+            af::array mainlobe = af::abs(bins - af::tile(idx_arr.as(s32), nfft)) <= d_mainlobe_half;
+            af::array P_side = af::select(mainlobe, 0.0, af::pow(af_abs_fft.as(f64), 2));
+            af::array n_side = af::max(static_cast<double>(nfft) - af::count(mainlobe, 0).as(f64), 1.0);
+
+            // NLLS neighbourhood of the peak, clamped to the spectrum edges
+            af::array off = af::range(af::dim4(d_nlls_pts), 0, s32) - static_cast<int>(d_nlls_pts / 2);
+            af::array nbhd = af::clamp(af::tile(idx_arr.as(s32), d_nlls_pts) + off, 0.0, static_cast<double>(nfft - 1));
+
+            // Single download:
+            // [peak bin, peak, noise, sidelobe, neighbourhood]
+            af::array stats = af::join(0,
+                                       af::join(0, idx_arr.as(f64), max_arr.as(f64)),
+                                       af::join(0, af::sum(P_side, 0) / n_side, af::max(P_side, 0)),
+                                       af_abs_fft(nbhd).as(f64));
+            std::vector<double> stats_host(stats.elements());
+            stats.host(stats_host.data());
+
+            // Frequency of the peak bin
+            pk.f_pk = (-samp_rate / 2.0) + stats_host[0] * (samp_rate / nfft);
+            pk.peak = stats_host[1];
+            pk.noise = stats_host[2];
+            pk.sidelobe = stats_host[3];
+            std::copy(stats_host.begin() + 4, stats_host.end(), d_nlls_y.begin());
+        }
+
+        const frequency_pk_est_impl::czt_plan &frequency_pk_est_impl::get_czt_plan(size_t n)
+        {
+            auto it = d_czt_cache.find(n);
+            if (it != d_czt_cache.end())
+                return it->second;
+
+            // Zoom span: the coarse mainlobe plus one bin either side, at the
+            // fine bin spacing fs / NFFT
+            const long long nfft = static_cast<long long>(fft_ratio * n);
+            const long long two_nfft = 2 * nfft;
+            czt_plan plan;
+            plan.span = static_cast<long long>(std::max(2.0, std::ceil(d_cap / d_width) + 1.0));
+            plan.M = 2 * plan.span * static_cast<long long>(fft_ratio) + 1;
+            plan.P = 1;
+            while (plan.P < static_cast<dim_t>(n) + plan.M - 1)
+                plan.P <<= 1;
+
+            // Bluestein chirps exp(-+j pi j^2 / NFFT); j^2 is reduced modulo
+            // 2 NFFT in integers so the phase stays exact for long captures
+            auto chirp = [&](long long j, double sign)
+            {
+                double ph = sign * M_PI * static_cast<double>((j * j) % two_nfft) / nfft;
+                return std::complex<float>(std::cos(ph), std::sin(ph));
+            };
+            std::vector<std::complex<float>> w_in(n), w_out(plan.M), b(plan.P, 0);
+            for (long long k = 0; k < static_cast<long long>(n); k++)
+                w_in[k] = chirp(k, -1.0);
+            for (long long m = 0; m < plan.M; m++)
+            {
+                w_out[m] = chirp(m, -1.0);
+                b[m] = chirp(m, 1.0);
+            }
+            for (long long k = 1; k < static_cast<long long>(n); k++)
+                b[plan.P - k] = chirp(k, 1.0);
+
+            plan.w_in = af::array(n, reinterpret_cast<const af::cfloat *>(w_in.data()));
+            plan.w_out = af::array(plan.M, reinterpret_cast<const af::cfloat *>(w_out.data()));
+            plan.B = af::fft(af::array(plan.P, reinterpret_cast<const af::cfloat *>(b.data())));
+            plan.k = af::range(af::dim4(n), 0, s64);
+
+            return d_czt_cache.emplace(n, plan).first->second;
+        }
+
+        void frequency_pk_est_impl::zoom_spectrum(const af::array &af_input, size_t n, spectrum_peak &pk)
+        {
+            const long long nfft = static_cast<long long>(fft_ratio * n);
+            const czt_plan &plan = get_czt_plan(n);
+
+            // Coarse, unpadded FFT: peak bin, noise floor and sidelobe level
+            // (per-bin noise power does not depend on the zero padding)
+            af::array coarse = af::abs(af::fft(af_input));
+            af::array c_val, c_idx;
+            af::max(c_val, c_idx, coarse, 0);
+            af::array bins = af::range(af::dim4(n), 0, s32);
+            af::array dist = af::abs(bins - af::tile(c_idx.as(s32), n));
+            dist = af::min(dist, static_cast<int>(n) - dist);
+            af::array mainlobe = dist <= static_cast<int>(std::ceil(d_cap / d_width));
+            af::array P_side = af::select(mainlobe, 0.0, af::pow(coarse.as(f64), 2));
+            af::array n_side = af::max(static_cast<double>(n) - af::count(mainlobe, 0).as(f64), 1.0);
+
+            // Signed fine bin at the start of the zoom span, kept on the
+            // device so the coarse peak needs no extra round trip
+            const long long nn = static_cast<long long>(n);
+            af::array kc = c_idx.as(s64);
+            af::array c = af::select(kc < (nn + 1) / 2, kc, kc - nn);
+            af::array b0 = (c - plan.span) * static_cast<long long>(fft_ratio);
+            af::array b0_mod = af::mod(af::mod(b0, nfft) + nfft, nfft);
+
+            // Chirp-Z over bins b0 .. b0 + M - 1: modulate to b0 (phase
+            // b0 * k mod NFFT kept in integers), chirp, convolve, de-chirp
+            af::array mod_ph = af::mod(plan.k * af::tile(b0_mod, n), nfft).as(f64) * (-2.0 * M_PI / nfft);
+            af::array a = af_input * plan.w_in * af::complex(af::cos(mod_ph), af::sin(mod_ph)).as(c32);
+            af::array y = af::ifft(af::fft(a, plan.P) * plan.B);
+            af::array zoom = af::abs(y(af::seq(0, plan.M - 1)) * plan.w_out);
+
+            // Fine peak and NLLS neighbourhood, clamped to the zoom span
+            af::array f_val, f_idx;
+            af::max(f_val, f_idx, zoom, 0);
+            af::array off = af::range(af::dim4(d_nlls_pts), 0, s32) - static_cast<int>(d_nlls_pts / 2);
+            af::array nbhd = af::clamp(af::tile(f_idx.as(s32), d_nlls_pts) + off, 0.0, static_cast<double>(plan.M - 1));
+
+            // Single download:
+            // [fine bin of the peak, peak, noise, sidelobe, neighbourhood]
+            af::array stats = af::join(0,
+                                       af::join(0, (b0 + f_idx.as(s64)).as(f64), f_val.as(f64)),
+                                       af::join(0, af::sum(P_side, 0) / n_side, af::max(P_side, 0)),
+                                       zoom(nbhd).as(f64));
+            std::vector<double> stats_host(stats.elements());
+            stats.host(stats_host.data());
+
+            pk.f_pk = stats_host[0] * samp_rate / nfft;
+            pk.peak = stats_host[1];
+            pk.noise = stats_host[2];
+            pk.sidelobe = stats_host[3];
+            std::copy(stats_host.begin() + 4, stats_host.end(), d_nlls_y.begin());
+        }
+
+        void frequency_pk_est_impl::link_metrics(double peak, double noise, double sidelobe, double n,
+                                                 double &snr_db, double &pslr_db, double &var_f)
         {
-            return af::select(x == 0.0, 1.0, af::sin(af::Pi * x) / (af::Pi * x));
+            // SNR of the peak bin over the noise floor, PSLR, and the
+            // frequency CRLB using the per-sample SNR implied by the
+            // coherent gain of the pulse (N = pulse_width * samp_rate)
+            double peak_pw = peak * peak;
+            double snr_bin = peak_pw / std::max(noise, std::numeric_limits<double>::min());
+            double pslr = peak_pw / std::max(sidelobe, std::numeric_limits<double>::min());
+            double N_pulse = pulse_width * samp_rate;
+            double snr_sample = snr_bin * n / (N_pulse * N_pulse);
+            var_f = 3.0 / (2.0 * std::pow(M_PI, 2.0) * std::pow(pulse_width, 3.0) * samp_rate *
+                           snr_sample * (1.0 - std::pow(1.0 / N_pulse, 2.0)));
+            snr_db = 10.0 * std::log10(snr_bin);
+            pslr_db = 10.0 * std::log10(pslr);
+        }
+
+        void frequency_pk_est_impl::fdma_estimate(const af::array &af_input, size_t n)
+        {
+            double NFFT = fft_ratio * n;
+            const int nfft = static_cast<int>(NFFT);
+
+            // One FFT for every transmitter
+            af::array af_abs_fft = af::abs(::plasma::fftshift(af::fft(af_input, NFFT), 0));
+            if (enable_out)
+            {
+                size_t io(0);
+                d_data = pmt::make_f32vector(NFFT, 0);
+                af_abs_fft.host(pmt::f32vector_writable_elements(d_data, io));
+                message_port_pub(d_out_port, pmt::cons(d_meta, d_data));
+            }
+
+            // Expected (fftshifted) bin of every other platform's tone, and a
+            // search half-width that keeps neighbouring tones apart
+            std::vector<int> txs;
+            std::vector<int> centers;
+            double min_spacing = NFFT;
+            for (size_t i = 0; i < d_fdma_tones.size(); i++)
+            {
+                for (size_t j = i + 1; j < d_fdma_tones.size(); j++)
+                    min_spacing = std::min(min_spacing, std::abs(d_fdma_tones[i] - d_fdma_tones[j]) * NFFT / samp_rate);
+                if (static_cast<int>(i) + 1 == sdr_id)
+                    continue;
+                txs.push_back(static_cast<int>(i) + 1);
+                centers.push_back(static_cast<int>(std::lround(d_fdma_tones[i] * NFFT / samp_rate)) + nfft / 2);
+            }
+            if (txs.empty())
+                return;
+            int half = std::max(2 * d_mainlobe_half, static_cast<int>(d_nlls_pts));
+            half = std::max(std::min(half, static_cast<int>(min_spacing / 2.0)), 1);
+            const dim_t W = 2 * half + 1;
+            const dim_t T = txs.size();
+
+            // Batched search: W x T window of bins, max along each column
+            af::array center_arr(af::dim4(1, T), centers.data());
+            af::array win_idx = af::tile(center_arr, W) + af::tile(af::range(af::dim4(W), 0, s32) - half, 1, T);
+            win_idx = af::clamp(win_idx, 0.0, NFFT - 1.0);
+            af::array win = af::moddims(af_abs_fft(af::flat(win_idx)), W, T);
+            af::array pk_val, pk_loc;
+            af::max(pk_val, pk_loc, win, 0);
+            af::array pk_bin = af::moddims(win_idx(af::flat(pk_loc.as(s32) + af::range(af::dim4(1, T), 1, s32) * W)), 1, T);
+
+            // NLLS neighbourhoods of every tone
+            af::array off = af::range(af::dim4(d_nlls_pts, T), 0, s32) - static_cast<int>(d_nlls_pts / 2);
+            af::array nbhd = af::clamp(af::tile(pk_bin, d_nlls_pts) + off, 0.0, NFFT - 1.0);
+
+            // Noise floor and strongest sidelobe outside every tone's mainlobe
+            af::array bins = af::tile(af::range(af::dim4(nfft), 0, s32), 1, T);
+            af::array mainlobe = af::anyTrue(af::abs(bins - af::tile(pk_bin, nfft)) <= d_mainlobe_half, 1);
+            af::array P_side = af::select(mainlobe, 0.0, af::pow(af_abs_fft.as(f64), 2));
+            af::array n_side = af::max(NFFT - af::count(mainlobe, 0).as(f64), 1.0);
+
+            // Single download: [bins (T), peaks (T), noise, sidelobe, neighbourhoods]
+            af::array stats = af::join(0,
+                                       af::join(0, af::flat(pk_bin).as(f64), af::flat(pk_val).as(f64)),
+                                       af::join(0, af::sum(P_side, 0) / n_side, af::max(P_side, 0)),
+                                       af::flat(af_abs_fft(af::flat(nbhd))).as(f64));
+            std::vector<double> stats_host(stats.elements());
+            stats.host(stats_host.data());
+            const double noise = stats_host[2 * T];
+            const double sidelobe = stats_host[2 * T + 1];
+            const double *nbhd_host = stats_host.data() + 2 * T + 2;
+
+            auto to_pmt_f64 = [&](const std::vector<double> &v)
+            {
+                return pmt::init_f64vector(v.size(), const_cast<double *>(v.data()));
+            };
+
+            d_meta_f = pmt::make_dict();
+            for (dim_t t = 0; t < T; t++)
+            {
+                double max_fft = stats_host[T + t];
+                double f_pk = (-samp_rate / 2.0) + stats_host[t] * (samp_rate / NFFT);
+
+                // lambda = {amplitude, peak offset (bins), sinc width}
+                std::array<double, 3> lambda = {max_fft, 0.0, pulse_width / cap_length};
+                sinc_nlls_fit(nbhd_host + t * d_nlls_pts, d_nlls_pts, lambda, static_cast<int>(NLLS_iter));
+                float f_tone = f_pk + (lambda[1] / (cap_length * fft_ratio));
+
+                double snr_db, pslr_db, var_f;
+                link_metrics(max_fft, noise, sidelobe, n, snr_db, pslr_db, var_f);
+
+                int tx = txs[t];
+                d_meta_f = pmt::dict_add(d_meta_f, harmonia_sdr_key("sdr", tx), pmt::init_f32vector(1, &f_tone));
+                d_meta_f = pmt::dict_add(d_meta_f, harmonia_sdr_key("tone_sdr", tx), pmt::from_double(d_fdma_tones[tx - 1]));
+                d_meta_f = pmt::dict_add(d_meta_f, harmonia_sdr_key("snr_sdr", tx), to_pmt_f64({snr_db}));
+                d_meta_f = pmt::dict_add(d_meta_f, harmonia_sdr_key("pslr_sdr", tx), to_pmt_f64({pslr_db}));
+                d_meta_f = pmt::dict_add(d_meta_f, harmonia_sdr_key("var_sdr", tx), to_pmt_f64({var_f}));
+            }
+            d_meta_f = pmt::dict_add(d_meta_f, pmt::intern("rx_id"), sdr_pmt);
+
+            pmt::pmt_t empty_payload = pmt::make_u8vector(0, 0);
+            message_port_pub(d_f_out_port, pmt::cons(d_meta_f, empty_payload));
         }
 
         void frequency_pk_est_impl::handle_msg(pmt::pmt_t msg)
@@ -119,109 +423,63 @@ namespace gr
             // Retrieves length of samples
             size_t n = pmt::length(samples);
             // GR_LOG_INFO(d_logger, "Received PDU with length: " + std::to_string(n));
-            double NFFT = fft_ratio * n;
-            // GR_LOG_INFO(d_logger, "NFFT: " + std::to_string(NFFT));
 
             // Casting data into array
             const std::complex<float> *in_data = pmt::c32vector_elements(samples, n);
             af::array af_input = af::array(n, reinterpret_cast<const af::cfloat *>(in_data));
 
-            // FFT
-            af::array af_fft = af::fft(af_input, NFFT);
-
-            // FFTshift to zero
-            af_fft = ::plasma::fftshift(af_fft, 0);
-            af::array af_abs_fft = af::abs(af_fft);
-
-            // Output absolute fft of input data
-            size_t io(0);
-            d_data = pmt::make_f32vector(NFFT, 0);
-            float *out = pmt::f32vector_writable_elements(d_data, io);
-            af_abs_fft.host(out);
-
-            // Send the data as a message
-            if (enable_out)
+            // All transmitters at once on distinct tones
+            if (!d_fdma_tones.empty())
             {
-                message_port_pub(d_out_port, pmt::cons(d_meta, d_data));
+                set_spectral_params(cap_length, pulse_width);
+                fdma_estimate(af_input, n);
+                d_meta = pmt::make_dict();
+                return;
             }
 
-            // Output max and index of data
-            double max_fft;
-            unsigned max_idx;
-            af::max(&max_fft, &max_idx, af_abs_fft);
-
-            // Generate frequency axis
-            af::array f_axis =
-                (-samp_rate / 2.0) + ((af::seq(0, NFFT - 1)) * (samp_rate / (NFFT)));
-            f_axis = f_axis.as(f64);
-            af::array f_pk = f_axis(max_idx); // Get the value at max_idx as an af::array
-            // af_print(f_pk);
-
-            // ----------------- Sinc-NLLS -----------------
-            // Create lambda array
-            double lambda[] = {max_fft, 0.0, pulse_width / cap_length};
-            af::array af_lambda(3, lambda, afHost);
-
-            // Making Index for NLLS
-            double NLLS_pts = std::ceil(fft_ratio * 2.0 * pulse_width / cap_length) - 1.0;
-
-            // Minimum Number of Points = 3
-            if (NLLS_pts < 5.0)
-                NLLS_pts = 5.0;
-            // GR_LOG_INFO(d_logger, "NLLS Points: " + std::to_string(NLLS_pts));
-
-            // NLLS Index Vector
-            af::array nlls_ind = af::seq(0.0, NLLS_pts - 1.0);
-            nlls_ind = nlls_ind - af::median(nlls_ind);
-            nlls_ind = nlls_ind.as(f64);
-            // af_print(nlls_ind);
-            af::array max_vector = af::constant(static_cast<double>(max_idx), static_cast<dim_t>(NLLS_pts));
-
-            // Output vector of points around max index
-            af::array nlls_y = af_abs_fft(max_vector - nlls_ind);
-            nlls_y = af::flip(nlls_y, 0);
-            nlls_y = nlls_y.as(f64);
-            // af_print(nlls_y);
-
-            // Iterates through NLLS x times
-            for (int iter = 0; iter < NLLS_iter; ++iter)
+            // Non-coherent: integrate the M pulse intervals. Otherwise
+            // transform the whole capture, materialising the fine spectrum
+            // only when it is published and else refining a coarse FFT with a
+            // chirp-Z zoom. A coherent pulse train is the whole capture too:
+            // its line at the tone is as wide as the capture, with full
+            // M-pulse gain, and repeats every PRF.
+            spectrum_peak pk;
+            double n_eff = n;
+            const bool train = d_num_pulses > 1;
+            bool integrate = train && !d_coherent && n >= 2 * static_cast<size_t>(d_num_pulses);
+            if (integrate)
             {
-                af::array x = nlls_ind - af_lambda(1);
-                af::array z = x * af_lambda(2);
-                af::array sinc_z = sinc(z);
-                af::array cos_z = af::cos(af::Pi * z);
-                af::array nlls_f = af_lambda(0) * sinc_z;
-
-                // Jacobian Matrix
-                af::array GN1 = sinc_z;
-                af::array GN2 = af_lambda(0) * (sinc_z - cos_z) / (x);
-                af::array GN3 = af_lambda(0) * x * (cos_z - sinc_z) / af_lambda(2);
-                af::array J = af::join(1, GN1, GN2, GN3);
-
-                // Replace Infinite and NaNs with zeros
-                af::replace(J, !(af::isInf(J)), 0.0);
-                af::replace(J, !(af::isNaN(J)), 0.0);
-
-                // Residual
-                af::array r = nlls_y - nlls_f;
-
-                // Solve for lambda
-                af::array JTJ = af::matmulTN(J, J);
-                af::array JTr = af::matmulTN(J, r);
-                af::array delta = af::solve(JTJ, JTr);
-
-                af_lambda += delta;
+                set_spectral_params(cap_length / d_num_pulses, pulse_width);
+                integrated_spectrum(af_input, n, pk);
+                // Noise adds over M pulses, as does the signal power
+                n_eff = static_cast<double>(n / d_num_pulses);
             }
-            // Output Lambda
-            af_lambda.host(lambda);
-            // af_print(af_lambda);
+            else
+            {
+                set_spectral_params(cap_length, train ? cap_length : pulse_width);
+                if (enable_out)
+                    full_spectrum(af_input, n, pk);
+                else
+                    zoom_spectrum(af_input, n, pk);
+                // Coherent signal amplitude adds as M
+                if (train)
+                    n_eff = static_cast<double>(n) / (d_num_pulses * d_num_pulses);
+            }
+            double max_fft = pk.peak;
+            double f_pk = pk.f_pk;
+
+            // ----------------- Sinc-NLLS -----------------
+            // lambda = {amplitude, peak offset (bins), sinc width}
+            std::array<double, 3> lambda = {max_fft, 0.0, d_width / d_cap};
+            sinc_nlls_fit(d_nlls_y.data(), d_nlls_pts, lambda, static_cast<int>(NLLS_iter));
 
             // Compute frequency estimate
-            af::array f_est_arr = f_pk + (af_lambda(1) / (cap_length * fft_ratio));
-            // af_print(f_est_arr);
+            f_est = f_pk + (lambda[1] / (d_cap * fft_ratio));
 
-            // Output frequency estimate
-            f_est_arr.host(&f_est);
+            double snr_db, pslr_db, var_f;
+            link_metrics(max_fft, pk.noise, pk.sidelobe, n_eff, snr_db, pslr_db, var_f);
+            if (train)
+                var_f /= d_num_pulses;
 
             if (d_rx_count < 2)
             {
@@ -246,6 +504,15 @@ namespace gr
                         d_sdr2_estimates.push_back(f_est);
                     break;
                 }
+
+                // Transmitters arrive in ascending order, skipping this platform
+                int tx_id = d_rx_count + 1;
+                if (tx_id >= sdr_id)
+                    tx_id++;
+                link_quality &q = d_quality[tx_id];
+                q.snr.push_back(snr_db);
+                q.pslr.push_back(pslr_db);
+                q.var.push_back(var_f);
             }
             d_rx_count++;
 
@@ -253,12 +520,22 @@ namespace gr
             {
                 return pmt::init_f32vector(v.size(), const_cast<float *>(v.data()));
             };
+            auto to_pmt_f64 = [&](const std::vector<double> &v)
+            {
+                return pmt::init_f64vector(v.size(), const_cast<double *>(v.data()));
+            };
 
             if (d_rx_count == 2)
             {
                 d_meta_f = pmt::dict_add(d_meta_f, PMT_HARMONIA_SDR1, to_pmt_f32(d_sdr1_estimates));
                 d_meta_f = pmt::dict_add(d_meta_f, PMT_HARMONIA_SDR2, to_pmt_f32(d_sdr2_estimates));
                 d_meta_f = pmt::dict_add(d_meta_f, PMT_HARMONIA_SDR3, to_pmt_f32(d_sdr3_estimates));
+                for (const auto &q : d_quality)
+                {
+                    d_meta_f = pmt::dict_add(d_meta_f, harmonia_sdr_key("snr_sdr", q.first), to_pmt_f64(q.second.snr));
+                    d_meta_f = pmt::dict_add(d_meta_f, harmonia_sdr_key("pslr_sdr", q.first), to_pmt_f64(q.second.pslr));
+                    d_meta_f = pmt::dict_add(d_meta_f, harmonia_sdr_key("var_sdr", q.first), to_pmt_f64(q.second.var));
+                }
                 d_meta_f = pmt::dict_add(d_meta_f, pmt::intern("rx_id"), sdr_pmt);
 
                 pmt::pmt_t empty_payload = pmt::make_u8vector(0, 0);
@@ -272,6 +549,21 @@ namespace gr
 
         void frequency_pk_est_impl::set_msg_queue_depth(size_t depth) { d_queue_depth = depth; }
 
+        void frequency_pk_est_impl::set_fdma_tones(const std::vector<double> &tones)
+        {
+            if (!tones.empty() && static_cast<int>(tones.size()) < sdr_id)
+                GR_LOG_WARN(d_logger, "FDMA tone list does not cover this platform");
+            d_fdma_tones = tones;
+        }
+
+        void frequency_pk_est_impl::set_pulse_integration(int num_pulses, bool coherent)
+        {
+            d_num_pulses = std::max(num_pulses, 1);
+            d_coherent = coherent;
+            // The zoom span depends on the line width, which the mode sets
+            d_czt_cache.clear();
+        }
+
         void frequency_pk_est_impl::set_backend(Device::Backend backend)
         {
             switch (backend)
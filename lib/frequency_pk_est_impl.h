@@ -13,6 +13,8 @@
 #include <gnuradio/harmonia/pmt_constants.h>
 #include <plasma_dsp/fft.h>
 #include <cmath>
+#include <map>
+#include <vector>
 
 namespace gr {
 namespace harmonia {
@@ -36,7 +38,46 @@ private:
     std::vector<float> d_sdr1_estimates;
     std::vector<float> d_sdr2_estimates;
     std::vector<float> d_sdr3_estimates;
-    af::array nlls_ind;
+    size_t d_nlls_pts;
+    std::vector<double> d_nlls_y;
+    int d_mainlobe_half;
+    double d_cap;   // capture (or pulse interval) length the above are sized for
+    double d_width; // duration of the sinc the spectral line is fitted with
+
+    // Per-link quality metrics, keyed by transmitting platform
+    struct link_quality {
+        std::vector<double> snr;  // dB
+        std::vector<double> pslr; // dB
+        std::vector<double> var;  // CRLB of the frequency estimate (Hz^2)
+    };
+    std::map<int, link_quality> d_quality;
+
+    // Peak of the fine spectrum and the link quality reductions around it
+    struct spectrum_peak {
+        double f_pk;
+        double peak;
+        double noise;
+        double sidelobe;
+    };
+
+    // Bluestein chirp-Z plan for one capture length
+    struct czt_plan {
+        long long span; // zoom half-width in coarse bins
+        dim_t M;        // number of fine output bins
+        dim_t P;        // convolution FFT length
+        af::array w_in;
+        af::array w_out;
+        af::array B;
+        af::array k;
+    };
+    std::map<size_t, czt_plan> d_czt_cache;
+
+    // FDMA mode: baseband tone of each platform (empty for TDMA)
+    std::vector<double> d_fdma_tones;
+
+    // Multi-pulse integration (off when d_num_pulses == 1)
+    int d_num_pulses;
+    bool d_coherent;
     int d_rx_count;
 
     // Message Ports    
@@ -52,7 +93,15 @@ private:
     pmt::pmt_t d_meta_f;
     pmt::pmt_t sdr_pmt;
 
-    af::array sinc(const af::array &x);
+    void set_spectral_params(double cap, double width);
+    void full_spectrum(const af::array &af_input, size_t n, spectrum_peak &pk);
+    void integrated_spectrum(const af::array &af_input, size_t n, spectrum_peak &pk);
+    void spectrum_peak_search(const af::array &af_abs_fft, spectrum_peak &pk);
+    const czt_plan &get_czt_plan(size_t n);
+    void zoom_spectrum(const af::array &af_input, size_t n, spectrum_peak &pk);
+    void link_metrics(double peak, double noise, double sidelobe, double n,
+                      double &snr_db, double &pslr_db, double &var_f);
+    void fdma_estimate(const af::array &af_input, size_t n);
 
     void handle_msg(pmt::pmt_t msg);
 
@@ -62,6 +111,8 @@ public:
     ~frequency_pk_est_impl();
 
     void set_msg_queue_depth(size_t) override;
+    void set_fdma_tones(const std::vector<double> &tones) override;
+    void set_pulse_integration(int num_pulses, bool coherent) override;
     void set_backend(Device::Backend) override;
 };
 
@@ -0,0 +1,67 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_HARMONIA_MATCHED_FILTER_H
+#define INCLUDED_HARMONIA_MATCHED_FILTER_H
+
+#include <gnuradio/harmonia/pmt_constants.h>
+#include <gnuradio/gr_complex.h>
+#include <arrayfire.h>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    /*
+     * Matched filter spectrum shared between the waveform sources and the
+     * correlators. A source attaches H = FFT_nfft(conj(flip(x))) to its PDU
+     * metadata as mf_spectrum, tagged with mf_nfft and the reference length
+     * mf_length, so a correlator whose overlap-save size matches can use it
+     * without rebuilding it.
+     */
+
+    // Overlap-save block size for a reference of n samples: the next power
+    // of two >= 4n
+    inline dim_t mf_nfft(dim_t n)
+    {
+      dim_t nfft = 1;
+      while (nfft < 4 * n)
+        nfft <<= 1;
+      return nfft;
+    }
+
+    inline af::array mf_spectrum(const af::array &x, dim_t nfft)
+    {
+      return af::fft(af::flip(af::conjg(x), 0), nfft);
+    }
+
+    // Add a matched filter spectrum for a reference of n samples to meta
+    inline pmt::pmt_t attach_mf_spectrum(pmt::pmt_t meta, pmt::pmt_t spectrum, size_t n)
+    {
+      meta = pmt::dict_add(meta, PMT_HARMONIA_MF_SPECTRUM, spectrum);
+      meta = pmt::dict_add(meta, PMT_HARMONIA_MF_NFFT, pmt::from_long(pmt::length(spectrum)));
+      meta = pmt::dict_add(meta, PMT_HARMONIA_MF_LENGTH, pmt::from_long(n));
+      return meta;
+    }
+
+    // Compute the matched filter spectrum of x[0..n) and add it to meta
+    inline pmt::pmt_t attach_mf_spectrum(pmt::pmt_t meta, const gr_complex *x, size_t n)
+    {
+      const dim_t nfft = mf_nfft(n);
+      af::array H = mf_spectrum(af::array(af::dim4(n), reinterpret_cast<const af::cfloat *>(x)), nfft);
+
+      pmt::pmt_t spectrum = pmt::make_c32vector(nfft, gr_complex(0.0f, 0.0f));
+      size_t len = 0;
+      H.host(reinterpret_cast<af::cfloat *>(pmt::c32vector_writable_elements(spectrum, len)));
+      return attach_mf_spectrum(meta, spectrum, n);
+    }
+
+  } // namespace harmonia
+} // namespace gr
+
+#endif /* INCLUDED_HARMONIA_MATCHED_FILTER_H */
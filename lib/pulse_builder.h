@@ -0,0 +1,95 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_HARMONIA_PULSE_BUILDER_H
+#define INCLUDED_HARMONIA_PULSE_BUILDER_H
+
+#include <gnuradio/gr_complex.h>
+#include <pmt/pmt.h>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    /*
+     * Allocation-free pulse train construction on the host.
+     *
+     * The train is laid out as zeropad / 2 zeros, the pulse, zeros up to
+     * the PRI (prf > 0), and zeropad / 2 zeros. The output PDU vector is
+     * sized once and the pulse is generated in place, instead of growing
+     * the waveform with joins and casting it from f64.
+     */
+    struct pulse_layout
+    {
+      size_t lead;  // samples before the pulse
+      size_t pulse; // pulse samples
+      size_t total; // whole train
+    };
+
+    inline pulse_layout pulse_train_layout(double samp_rate, double pulse_width, double prf, int zeropad)
+    {
+      pulse_layout l;
+      l.pulse = static_cast<size_t>(std::round(samp_rate * pulse_width));
+      size_t body = l.pulse;
+      if (prf > 0)
+        body = std::max(body, static_cast<size_t>(std::round(samp_rate / prf)));
+      l.lead = zeropad > 0 ? zeropad / 2 : 0;
+      l.total = body + 2 * l.lead;
+      return l;
+    }
+
+    // Zeroed PDU vector for the train; pulse points at the pulse start
+    inline pmt::pmt_t make_pulse_train(const pulse_layout &l, gr_complex **pulse)
+    {
+      pmt::pmt_t data = pmt::make_c32vector(l.total, gr_complex(0.0f, 0.0f));
+      size_t len = 0;
+      *pulse = pmt::c32vector_writable_elements(data, len) + l.lead;
+      return data;
+    }
+
+    /*
+     * out[k] = exp(j (2 pi (a k + b k^2) + c)), k < n (a, b in cycles).
+     *
+     * Uses the second-order recurrence z[k+1] = z[k] w[k], w[k+1] = w[k] r
+     * with r = exp(j 4 pi b) in double precision, reseeded from the closed
+     * form every `reseed` samples so rounding cannot accumulate over long
+     * pulses. The cycle count is reduced modulo 1 before scaling.
+     */
+    inline void quadratic_phase(gr_complex *out, size_t n, double a, double b, double c,
+                                size_t reseed = 1024)
+    {
+      auto cis = [](double cycles, double offset)
+      {
+        const double frac = cycles - std::floor(cycles);
+        return std::polar(1.0, 2.0 * M_PI * frac + offset);
+      };
+      const std::complex<double> r = cis(2.0 * b, 0.0);
+
+      for (size_t k0 = 0; k0 < n; k0 += reseed)
+      {
+        const double k = static_cast<double>(k0);
+        std::complex<double> z = cis(a * k + b * k * k, c);
+        std::complex<double> w = cis(a + b * (2.0 * k + 1.0), 0.0);
+        const size_t end = std::min(n, k0 + reseed);
+        for (size_t i = k0; i < end; i++)
+        {
+          out[i] = gr_complex(static_cast<float>(z.real()), static_cast<float>(z.imag()));
+          z *= w;
+          w *= r;
+        }
+      }
+    }
+
+  } // namespace harmonia
+} // namespace gr
+
+#endif /* INCLUDED_HARMONIA_PULSE_BUILDER_H */
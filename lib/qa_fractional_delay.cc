@@ -0,0 +1,147 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "fractional_delay.h"
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+
+namespace gr {
+namespace harmonia {
+
+namespace {
+
+const double fs = 1e6;
+
+// Gaussian-windowed tone centred in the capture: band-limited well inside
+// Nyquist and zero at the edges, so circular and linear delays agree
+std::vector<gr_complex> tone_burst(size_t n)
+{
+    std::vector<gr_complex> x(n);
+    const double centre = (n - 1) / 2.0, sigma = n / 16.0;
+    for (size_t k = 0; k < n; k++) {
+        const double t = k - centre;
+        x[k] = std::polar(static_cast<float>(std::exp(-0.5 * t * t / (sigma * sigma))),
+                          static_cast<float>(2.0 * M_PI * 0.11 * k));
+    }
+    return x;
+}
+
+// The compensation block's FFT path: multiply the spectrum by
+// exp(j 2 pi f t_delay), which advances the capture by t_delay seconds
+std::vector<gr_complex> fft_advance(const std::vector<gr_complex>& x, double t_delay)
+{
+    const size_t n = x.size();
+    std::vector<std::complex<double>> X(n);
+    for (size_t k = 0; k < n; k++)
+        for (size_t m = 0; m < n; m++)
+            X[k] += std::complex<double>(x[m]) * std::polar(1.0, -2.0 * M_PI * k * m / n);
+
+    std::vector<gr_complex> y(n);
+    for (size_t m = 0; m < n; m++) {
+        std::complex<double> acc = 0.0;
+        for (size_t k = 0; k < n; k++) {
+            // Signed bin so the ramp is linear phase across DC
+            const double f = (k < (n + 1) / 2 ? double(k) : double(k) - n) * fs / n;
+            acc += X[k] * std::polar(1.0, 2.0 * M_PI * f * t_delay) *
+                   std::polar(1.0, 2.0 * M_PI * k * m / n);
+        }
+        y[m] = gr_complex(acc / double(n));
+    }
+    return y;
+}
+
+double max_error(const std::vector<gr_complex>& a, const std::vector<gr_complex>& b)
+{
+    double err = 0.0;
+    for (size_t k = 0; k < a.size(); k++)
+        err = std::max(err, static_cast<double>(std::abs(a[k] - b[k])));
+    return err;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_fractional_delay_matches_fft)
+{
+    const size_t n = 256;
+    std::vector<gr_complex> x = tone_burst(n), y(n);
+    fractional_delay fir;
+
+    for (double delay : { 0.0, 0.25, 0.5, 1.7, 13.31, -0.4, -2.5, -9.93 }) {
+        // A delay of d samples is an advance of -d / fs
+        std::vector<gr_complex> ref = fft_advance(x, -delay / fs);
+        fir.apply(x.data(), y.data(), n, delay);
+        BOOST_CHECK_EQUAL(fir.integer_delay(), static_cast<long>(std::floor(delay)));
+        BOOST_CHECK_SMALL(max_error(y, ref), 1e-3);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_fractional_delay_compensation_sign)
+{
+    // compensation passes a rx_time_error advance of t_delay as a delay of
+    // -t_delay * fs samples: the burst peak must move earlier
+    const size_t n = 256;
+    std::vector<gr_complex> x = tone_burst(n), y(n);
+    const double t_delay = 6.0 / fs;
+
+    fractional_delay fir;
+    fir.apply(x.data(), y.data(), n, -t_delay * fs);
+    BOOST_CHECK_SMALL(max_error(y, fft_advance(x, t_delay)), 1e-3);
+
+    auto peak = [](const std::vector<gr_complex>& v) {
+        return std::max_element(v.begin(),
+                                v.end(),
+                                [](gr_complex a, gr_complex b) {
+                                    return std::abs(a) < std::abs(b);
+                                }) -
+               v.begin();
+    };
+    BOOST_CHECK_EQUAL(peak(x) - peak(y), 6);
+}
+
+BOOST_AUTO_TEST_CASE(test_fractional_delay_zero_padded_edges)
+{
+    // Integer delays are exact shifts; samples shifted in from outside the
+    // capture are zero
+    const size_t n = 64;
+    std::vector<gr_complex> x(n, gr_complex(1.0f, -1.0f)), y(n);
+    fractional_delay fir;
+
+    fir.apply(x.data(), y.data(), n, 5.0);
+    for (size_t m = 0; m < n; m++)
+        BOOST_CHECK_SMALL(std::abs(y[m] - (m < 5 ? gr_complex(0.0f) : x[m])), 1e-5f);
+
+    fir.apply(x.data(), y.data(), n, -5.0);
+    for (size_t m = 0; m < n; m++)
+        BOOST_CHECK_SMALL(std::abs(y[m] - (m + 5 < n ? x[m] : gr_complex(0.0f))), 1e-5f);
+
+    // Shifted entirely out of the capture, including delays far past it
+    // and NaN
+    for (double delay : { 100.5, -100.5, 1e300, -1e300, std::nan("") }) {
+        fir.apply(x.data(), y.data(), n, delay);
+        for (size_t m = 0; m < n; m++)
+            BOOST_CHECK_EQUAL(y[m], gr_complex(0.0f));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_fractional_delay_rejects_bad_arguments)
+{
+    BOOST_CHECK_THROW(fractional_delay(15), std::invalid_argument);
+    BOOST_CHECK_THROW(fractional_delay(0), std::invalid_argument);
+    BOOST_CHECK_THROW(fractional_delay(16, 0), std::invalid_argument);
+    // Validated before the coefficient table is sized from them
+    BOOST_CHECK_THROW(fractional_delay(-4), std::invalid_argument);
+    BOOST_CHECK_THROW(fractional_delay(16, -2), std::invalid_argument);
+    BOOST_CHECK(delay_method_from_string("fir") == delay_method::FIR);
+    BOOST_CHECK_THROW(delay_method_from_string("sinc"), std::invalid_argument);
+}
+
+} // namespace harmonia
+} // namespace gr
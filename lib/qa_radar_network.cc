@@ -0,0 +1,147 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "radar_network.h"
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace harmonia {
+
+namespace {
+
+const double c = 299792458.0;
+
+// usrp_radar_all settings the 3-node example reproduces (wire delays 0)
+const double start_delay = 1.0;
+const double TDMA_time = 10e-3;
+const double TDMA_time2 = 10e-3;
+const double wait_time = 5e-3;
+
+const std::vector<double> cd_est = { 1.0 + 2.1e-6, 1.0 - 0.7e-6, 1.0 + 3.3e-6 };
+const std::vector<double> cb_est = { 0.0, 1.25e-6, -4.5e-6 };
+const double R12_est = 12.34, R13_est = 56.78;
+
+std::vector<double> range_matrix()
+{
+    // Node-major N x N, symmetric
+    std::vector<double> R(9, 0.0);
+    R[0 * 3 + 1] = R[1 * 3 + 0] = R12_est;
+    R[0 * 3 + 2] = R[2 * 3 + 0] = R13_est;
+    return R;
+}
+
+const radar_phase& phase_named(const radar_network& net, const std::string& name)
+{
+    for (const auto& p : net.phases)
+        if (p.name == name)
+            return p;
+    throw std::runtime_error("no phase " + name);
+}
+
+void check_times(const std::vector<double>& got, const std::vector<double>& want)
+{
+    BOOST_REQUIRE_EQUAL(got.size(), want.size());
+    for (size_t k = 0; k < got.size(); k++)
+        BOOST_CHECK_SMALL(got[k] - want[k], 1e-12);
+}
+
+radar_network example()
+{
+    return parse_radar_network(HARMONIA_EXAMPLES_DIR "/usrp_radar_net_3node.json");
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_radar_network_parses_example)
+{
+    radar_network net = example();
+    BOOST_REQUIRE_EQUAL(net.nodes.size(), 3u);
+    BOOST_CHECK_EQUAL(net.nodes[1].args, "addr=192.168.60.2, use_dpkg=1");
+    BOOST_CHECK_EQUAL(net.nodes[2].rate, 100e6);
+    BOOST_CHECK_EQUAL(net.nodes[0].tx_antenna, "TX/RX");
+    BOOST_CHECK_EQUAL(net.nodes[0].rx_antenna, "TX/RX");
+    BOOST_CHECK_EQUAL(net.nodes[0].clock_source, "external");
+
+    BOOST_REQUIRE_EQUAL(net.phases.size(), 4u);
+    BOOST_CHECK_EQUAL(net.phases[2].after, "clock_drift");
+    BOOST_CHECK_EQUAL(net.phases[3].port, "cp_out");
+    BOOST_CHECK_EQUAL(net.phases[1].slots.size(), 3u);
+    BOOST_CHECK_EQUAL(net.phases[3].slots.size(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(test_radar_network_matches_cd_run)
+{
+    radar_network net = example();
+    auto tl = schedule_phase(net, phase_named(net, "clock_drift"), cd_est, cb_est, range_matrix());
+    const double t0 = start_delay * 2;
+
+    check_times(tl[0].tx_times, { (t0 + TDMA_time) * cd_est[0] });
+    check_times(tl[1].tx_times, { (t0 + TDMA_time * 2) * cd_est[1] });
+    check_times(tl[2].tx_times, { (t0 + TDMA_time * 3) * cd_est[2] });
+
+    check_times(tl[0].rx_times,
+                { (t0 + TDMA_time * 2 - wait_time) * cd_est[0],
+                  (t0 + TDMA_time * 3 - wait_time) * cd_est[0] });
+    check_times(tl[1].rx_times,
+                { (t0 + TDMA_time - wait_time) * cd_est[1],
+                  (t0 + TDMA_time * 3 - wait_time) * cd_est[1] });
+    check_times(tl[2].rx_times,
+                { (t0 + TDMA_time - wait_time) * cd_est[2],
+                  (t0 + TDMA_time * 2 - wait_time) * cd_est[2] });
+}
+
+BOOST_AUTO_TEST_CASE(test_radar_network_matches_cb_run)
+{
+    radar_network net = example();
+    auto tl = schedule_phase(net, phase_named(net, "clock_bias"), cd_est, cb_est, range_matrix());
+    const double t0 = start_delay * 3;
+    auto at = [&](int slot, int k) { return (t0 + TDMA_time2 * slot + cb_est[k]) * cd_est[k]; };
+
+    check_times(tl[0].tx_times, { at(1, 0) });
+    check_times(tl[1].tx_times, { at(2, 1) });
+    check_times(tl[2].tx_times, { at(3, 2) });
+
+    check_times(tl[0].rx_times, { at(2, 0), at(3, 0) });
+    check_times(tl[1].rx_times, { at(1, 1), at(3, 1) });
+    check_times(tl[2].rx_times, { at(1, 2), at(2, 2) });
+}
+
+BOOST_AUTO_TEST_CASE(test_radar_network_matches_cp_run)
+{
+    radar_network net = example();
+    auto tl = schedule_phase(net, phase_named(net, "carrier_phase"), cd_est, cb_est, range_matrix());
+    auto rx = [&](double t, int k) { return (t + cb_est[k]) * cd_est[k]; };
+
+    // cp_run, cp_run2 and cp_run3: sdr1 receives, sdr2 / sdr3 transmit
+    // advanced by their range to sdr1
+    check_times(tl[0].tx_times, {});
+    check_times(tl[0].rx_times,
+                { rx(start_delay * 4, 0), rx(start_delay * 4.05, 0), rx(start_delay * 4.1, 0) });
+    check_times(tl[1].tx_times,
+                { rx(start_delay * 4, 1) - R12_est / c, rx(start_delay * 4.05, 1) - R12_est / c });
+    check_times(tl[2].tx_times,
+                { rx(start_delay * 4.05, 2) - R13_est / c, rx(start_delay * 4.1, 2) - R13_est / c });
+    check_times(tl[1].rx_times, {});
+    check_times(tl[2].rx_times, {});
+}
+
+BOOST_AUTO_TEST_CASE(test_radar_network_rejects_malformed)
+{
+    BOOST_CHECK_THROW(parse_radar_network("{\"nodes\": []}"), std::invalid_argument);
+    BOOST_CHECK_THROW(parse_radar_network("{\"nodes\": [{\"args\": \"\"}]}"), std::invalid_argument);
+    BOOST_CHECK_THROW(parse_radar_network("{\"nodes\": "), std::invalid_argument);
+    BOOST_CHECK_THROW(parse_radar_network("/nonexistent/radar_net.json"), std::invalid_argument);
+    BOOST_CHECK_THROW(parse_radar_network("{\"nodes\": [{\"rate\": 1e6}], \"phases\": "
+                                          "[{\"capture\": 1e-3, \"slots\": [{\"tx\": [2]}]}]}"),
+                      std::invalid_argument);
+}
+
+} // namespace harmonia
+} // namespace gr
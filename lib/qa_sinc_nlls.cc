@@ -0,0 +1,84 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "sinc_nlls.h"
+#include <boost/test/unit_test.hpp>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace gr {
+namespace harmonia {
+
+namespace {
+
+// y[k] = A * sinc(beta * (k - c - mu)), c = (n - 1) / 2
+template <typename T>
+std::vector<T> sinc_points(size_t n, T A, T mu, T beta)
+{
+    std::vector<T> y(n);
+    const T half = static_cast<T>((n - 1) / 2);
+    for (size_t k = 0; k < n; k++) {
+        const T pz = static_cast<T>(M_PI) * (static_cast<T>(k) - half - mu) * beta;
+        y[k] = A * (pz == T(0) ? T(1) : std::sin(pz) / pz);
+    }
+    return y;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_sinc_nlls_recovers_parameters)
+{
+    const double A = 2.5, mu = 0.3, beta = 0.8;
+    for (size_t n = 3; n <= 31; n += 2) {
+        std::vector<double> y = sinc_points(n, A, mu, beta);
+
+        // Start on a sample (x = 0 at k = c) so the centre fix-up is hit
+        std::array<double, 3> lambda = { 2.0, 0.0, 1.0 };
+        BOOST_REQUIRE(sinc_nlls_fit(y.data(), n, lambda, 30));
+        BOOST_CHECK_SMALL(lambda[0] - A, 1e-9);
+        BOOST_CHECK_SMALL(lambda[1] - mu, 1e-9);
+        BOOST_CHECK_SMALL(lambda[2] - beta, 1e-9);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_sinc_nlls_negative_offset_float)
+{
+    const float A = 1.0f, mu = -0.45f, beta = 0.9f;
+    std::vector<float> y = sinc_points<float>(9, A, mu, beta);
+
+    std::array<float, 3> lambda = { 0.8f, 0.0f, 1.0f };
+    BOOST_REQUIRE(sinc_nlls_fit(y.data(), y.size(), lambda, 30));
+    BOOST_CHECK_SMALL(lambda[0] - A, 1e-4f);
+    BOOST_CHECK_SMALL(lambda[1] - mu, 1e-4f);
+    BOOST_CHECK_SMALL(lambda[2] - beta, 1e-4f);
+}
+
+BOOST_AUTO_TEST_CASE(test_sinc_nlls_exact_start_is_fixed_point)
+{
+    // Zero residual: the step must be zero, including the x = 0 row
+    const double A = 1.0, mu = 0.0, beta = 1.0;
+    std::vector<double> y = sinc_points(7, A, mu, beta);
+
+    std::array<double, 3> lambda = { A, mu, beta };
+    BOOST_REQUIRE(sinc_nlls_fit(y.data(), y.size(), lambda, 5));
+    BOOST_CHECK_SMALL(lambda[0] - A, 1e-12);
+    BOOST_CHECK_SMALL(lambda[1] - mu, 1e-12);
+    BOOST_CHECK_SMALL(lambda[2] - beta, 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(test_sinc_nlls_rejects_unsupported_sizes)
+{
+    std::vector<double> y(32, 0.0);
+    std::array<double, 3> lambda = { 1.0, 0.0, 1.0 };
+    BOOST_CHECK(!sinc_nlls_fit(y.data(), 4, lambda, 1));
+    BOOST_CHECK(!sinc_nlls_fit(y.data(), 1, lambda, 1));
+    BOOST_CHECK(!sinc_nlls_fit(y.data(), 33, lambda, 1));
+}
+
+} /* namespace harmonia */
+} /* namespace gr */
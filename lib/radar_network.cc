@@ -0,0 +1,234 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "radar_network.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    namespace
+    {
+      const double c = 299792458.0;
+
+      using json = nlohmann::json;
+
+      template <typename T>
+      T value_or(const json &j, const char *key, const T &fallback)
+      {
+        auto it = j.find(key);
+        return it == j.end() ? fallback : it->get<T>();
+      }
+
+      // Fields of a node, layered over base so "defaults" and the node
+      // entry share one reader. "gain", "antenna" and "subdev" set both
+      // directions; the tx_ / rx_ forms override them.
+      radar_node_config read_node(const json &j, radar_node_config base)
+      {
+        base.args = value_or(j, "args", base.args);
+        base.rate = value_or(j, "rate", base.rate);
+        base.freq = value_or(j, "freq", base.freq);
+
+        if (j.contains("gain"))
+          base.tx_gain = base.rx_gain = j["gain"].get<double>();
+        base.tx_gain = value_or(j, "tx_gain", base.tx_gain);
+        base.rx_gain = value_or(j, "rx_gain", base.rx_gain);
+
+        if (j.contains("antenna"))
+          base.tx_antenna = base.rx_antenna = j["antenna"].get<std::string>();
+        base.tx_antenna = value_or(j, "tx_antenna", base.tx_antenna);
+        base.rx_antenna = value_or(j, "rx_antenna", base.rx_antenna);
+
+        if (j.contains("subdev"))
+          base.tx_subdev = base.rx_subdev = j["subdev"].get<std::string>();
+        base.tx_subdev = value_or(j, "tx_subdev", base.tx_subdev);
+        base.rx_subdev = value_or(j, "rx_subdev", base.rx_subdev);
+
+        base.clock_source = value_or(j, "clock_source", base.clock_source);
+        base.time_source = value_or(j, "time_source", base.time_source);
+        base.cpu_format = value_or(j, "cpu_format", base.cpu_format);
+        base.otw_format = value_or(j, "otw_format", base.otw_format);
+        base.tx_wire_delay = value_or(j, "tx_wire_delay", base.tx_wire_delay);
+        base.rx_wire_delay = value_or(j, "rx_wire_delay", base.rx_wire_delay);
+        return base;
+      }
+
+      // 1-based node numbers in the file, 0-based in memory
+      std::vector<int> read_ids(const json &j, const char *key, int n_nodes,
+                                const std::string &phase)
+      {
+        std::vector<int> ids;
+        auto it = j.find(key);
+        if (it == j.end())
+          return ids;
+        for (const auto &v : *it)
+        {
+          int id = v.get<int>();
+          if (id < 1 || id > n_nodes)
+            throw std::invalid_argument("radar network phase '" + phase + "' names node " +
+                                        std::to_string(id) + " of " + std::to_string(n_nodes));
+          ids.push_back(id - 1);
+        }
+        return ids;
+      }
+
+      radar_phase read_phase(const json &j, int n_nodes, size_t index)
+      {
+        radar_phase p;
+        p.name = value_or(j, "name", "phase" + std::to_string(index + 1));
+        p.enable = value_or(j, "enable", p.enable);
+        p.after = value_or(j, "after", p.after);
+        p.needs = value_or(j, "needs", p.needs);
+        p.waveform = value_or(j, "waveform", p.waveform);
+        p.port = value_or(j, "port", p.port);
+        p.epoch = value_or(j, "epoch", p.epoch);
+        p.rx_lead = value_or(j, "rx_lead", p.rx_lead);
+        p.capture = value_or(j, "capture", p.capture);
+        p.drift = value_or(j, "drift", p.drift);
+        p.bias = value_or(j, "bias", p.bias);
+        p.range = value_or(j, "range", p.range);
+
+        if (!(p.capture > 0.0))
+          throw std::invalid_argument("radar network phase '" + p.name + "' needs a positive capture");
+        for (const auto &need : p.needs)
+          if (need != "drift" && need != "bias" && need != "waveform")
+            throw std::invalid_argument("radar network phase '" + p.name + "' has unknown need: " + need);
+
+        if (j.contains("slots"))
+        {
+          for (const auto &s : j["slots"])
+          {
+            radar_slot slot;
+            slot.tx = read_ids(s, "tx", n_nodes, p.name);
+            slot.rx = read_ids(s, "rx", n_nodes, p.name);
+            slot.offset = value_or(s, "offset", 0.0);
+            p.slots.push_back(slot);
+          }
+        }
+        else
+        {
+          // Round robin: node k transmits at epoch + slot_time * (k + 1)
+          double slot_time = value_or(j, "slot_time", 0.0);
+          if (!(slot_time > 0.0))
+            throw std::invalid_argument("radar network phase '" + p.name +
+                                        "' needs slots or a positive slot_time");
+          for (int k = 0; k < n_nodes; k++)
+          {
+            radar_slot slot;
+            slot.tx = {k};
+            for (int r = 0; r < n_nodes; r++)
+              if (r != k)
+                slot.rx.push_back(r);
+            slot.offset = slot_time * (k + 1);
+            p.slots.push_back(slot);
+          }
+        }
+        return p;
+      }
+    } // namespace
+
+    radar_network parse_radar_network(const std::string &config)
+    {
+      json j;
+      try
+      {
+        auto first = config.find_first_not_of(" \t\r\n");
+        if (first != std::string::npos && config[first] == '{')
+          j = json::parse(config);
+        else
+        {
+          std::ifstream file(config);
+          if (!file)
+            throw std::invalid_argument("cannot open radar network description: " + config);
+          j = json::parse(file);
+        }
+
+        radar_network net;
+        net.verbose = value_or(j, "verbose", false);
+
+        radar_node_config defaults = read_node(value_or(j, "defaults", json::object()), radar_node_config());
+        for (const auto &node : j.at("nodes"))
+          net.nodes.push_back(read_node(node, defaults));
+        if (net.nodes.empty())
+          throw std::invalid_argument("radar network has no nodes");
+        for (size_t k = 0; k < net.nodes.size(); k++)
+          if (!(net.nodes[k].rate > 0.0))
+            throw std::invalid_argument("radar network node " + std::to_string(k + 1) +
+                                        " needs a positive rate");
+
+        const int n = static_cast<int>(net.nodes.size());
+        const json phases = value_or(j, "phases", json::array());
+        for (size_t i = 0; i < phases.size(); i++)
+          net.phases.push_back(read_phase(phases[i], n, i));
+
+        for (const auto &p : net.phases)
+        {
+          auto named = [&](const std::string &name)
+          {
+            return std::count_if(net.phases.begin(), net.phases.end(),
+                                 [&](const radar_phase &q)
+                                 { return q.name == name; });
+          };
+          if (named(p.name) != 1)
+            throw std::invalid_argument("radar network phase name is not unique: " + p.name);
+          if (!p.after.empty() && named(p.after) == 0)
+            throw std::invalid_argument("radar network phase '" + p.name +
+                                        "' runs after unknown phase: " + p.after);
+        }
+        return net;
+      }
+      catch (const json::exception &e)
+      {
+        throw std::invalid_argument(std::string("malformed radar network description: ") + e.what());
+      }
+    }
+
+    std::vector<radar_timeline> schedule_phase(const radar_network &net,
+                                               const radar_phase &phase,
+                                               const std::vector<double> &drift,
+                                               const std::vector<double> &bias,
+                                               const std::vector<double> &range)
+    {
+      const size_t n = net.nodes.size();
+      std::vector<radar_timeline> timeline(n);
+
+      for (const auto &slot : phase.slots)
+      {
+        const double t = phase.epoch + slot.offset;
+        for (int k : slot.tx)
+        {
+          const radar_node_config &node = net.nodes[k];
+          double a = phase.drift ? drift[k] : 1.0;
+          double b = phase.bias ? bias[k] : 0.0;
+          double R = (phase.range && !slot.rx.empty()) ? range[slot.rx.front() * n + k] : 0.0;
+          timeline[k].tx_times.push_back((t - node.tx_wire_delay + b) * a - R / c);
+        }
+        for (int k : slot.rx)
+        {
+          const radar_node_config &node = net.nodes[k];
+          double a = phase.drift ? drift[k] : 1.0;
+          double b = phase.bias ? bias[k] : 0.0;
+          timeline[k].rx_times.push_back((t - phase.rx_lead + node.rx_wire_delay + b) * a);
+        }
+      }
+
+      // Each node's bursts go out in time order on its own streamer
+      for (auto &tl : timeline)
+      {
+        std::sort(tl.tx_times.begin(), tl.tx_times.end());
+        std::sort(tl.rx_times.begin(), tl.rx_times.end());
+      }
+      return timeline;
+    }
+
+  } // namespace harmonia
+} // namespace gr
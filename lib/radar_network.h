@@ -0,0 +1,116 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_HARMONIA_RADAR_NETWORK_H
+#define INCLUDED_HARMONIA_RADAR_NETWORK_H
+
+#include <string>
+#include <vector>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    /*
+     * One radio of the network. Every field can be given per node or once
+     * under "defaults" in the JSON description.
+     */
+    struct radar_node_config
+    {
+      std::string args;
+      double rate = 0.0;
+      double freq = 0.0;
+      double tx_gain = 0.0;
+      double rx_gain = 0.0;
+      std::string tx_antenna;
+      std::string rx_antenna;
+      std::string tx_subdev;
+      std::string rx_subdev;
+      std::string clock_source = "external";
+      std::string time_source;
+      std::string cpu_format = "fc32";
+      std::string otw_format = "sc16";
+      double tx_wire_delay = 0.0; // s, subtracted from TX times
+      double rx_wire_delay = 0.0; // s, added to RX times
+    };
+
+    /*
+     * One TDMA slot: the nodes in tx transmit at the slot time and the
+     * nodes in rx start capturing rx_lead earlier. Node indices are 0-based.
+     */
+    struct radar_slot
+    {
+      std::vector<int> tx;
+      std::vector<int> rx;
+      double offset = 0.0; // s after the phase epoch
+    };
+
+    /*
+     * One synchronisation phase (single tone, clock drift, clock bias,
+     * carrier phase, ...). A phase is armed at start ("enable": "start") or
+     * by the first waveform whose metadata sets the named flag, and runs
+     * once when every estimate in needs ("drift", "bias", "waveform") is
+     * available for all nodes and the phase named in after has run.
+     */
+    struct radar_phase
+    {
+      std::string name;
+      std::string enable = "start";
+      std::string after;
+      std::vector<std::string> needs;
+      std::string waveform; // TX waveform label, empty for the latest one
+      std::string port = "out";
+      double epoch = 0.0;   // s, nominal start of the phase
+      double rx_lead = 0.0; // s, RX starts this much before each slot
+      double capture = 0.0; // s, RX capture length
+      bool drift = false;   // scale slot times by the drift estimates
+      bool bias = false;    // shift slot times by the bias estimates
+      bool range = false;   // advance TX by the range to the slot's first RX
+      std::vector<radar_slot> slots;
+    };
+
+    struct radar_network
+    {
+      std::vector<radar_node_config> nodes;
+      std::vector<radar_phase> phases;
+      bool verbose = false;
+    };
+
+    /*
+     * Parse a network description given inline (a JSON object) or as the
+     * path of a JSON file. A phase without "slots" gets the round-robin
+     * schedule: every node transmits in turn, slot_time apart, and all
+     * other nodes receive. Throws std::invalid_argument on a malformed
+     * description.
+     */
+    radar_network parse_radar_network(const std::string &config);
+
+    /*
+     * Per-node burst times of one phase on the node's own clock:
+     *   TX: (t - tx_wire + b) * a - R / c
+     *   RX: (t - rx_lead + rx_wire + b) * a
+     * with t the nominal slot time, a / b the node's drift / bias when the
+     * phase applies them and R the range to the slot's first receiver.
+     * range is node-major N x N.
+     */
+    struct radar_timeline
+    {
+      std::vector<double> tx_times;
+      std::vector<double> rx_times;
+    };
+
+    std::vector<radar_timeline> schedule_phase(const radar_network &net,
+                                               const radar_phase &phase,
+                                               const std::vector<double> &drift,
+                                               const std::vector<double> &bias,
+                                               const std::vector<double> &range);
+
+  } // namespace harmonia
+} // namespace gr
+
+#endif /* INCLUDED_HARMONIA_RADAR_NETWORK_H */
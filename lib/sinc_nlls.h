@@ -0,0 +1,180 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_HARMONIA_SINC_NLLS_H
+#define INCLUDED_HARMONIA_SINC_NLLS_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    /*
+     * Sinc peak refinement by Gauss-Newton, run on the host.
+     *
+     * Fits y[k] = A * sinc(beta * (k - c - mu)) to N points centred on a
+     * coarse peak (c = (N - 1) / 2), with lambda = {A, mu, beta}.
+     * The x = 0 point gets its analytic Jacobian row; any other non-finite
+     * entry (beta = 0) is zeroed. The normal equations are accumulated per
+     * point and solved in closed form, so no storage beyond the fixed-size
+     * arrays is needed.
+     */
+    template <typename T, size_t N>
+    struct sinc_nlls
+    {
+      static_assert(N >= 3 && (N % 2) == 1, "sinc_nlls needs an odd number of points >= 3");
+
+      static void fit(const T *y, std::array<T, 3> &lambda, int iters)
+      {
+        constexpr T half = static_cast<T>((N - 1) / 2);
+
+        for (int it = 0; it < iters; it++)
+        {
+          std::array<T, N> g1, g2, g3, r;
+          const T A = lambda[0];
+          const T mu = lambda[1];
+          const T beta = lambda[2];
+
+          // One sin/cos pair per point, which the compiler fuses into a
+          // single sincos call. The libm calls keep the loop scalar. pz == 0
+          // only at the sampled centre (x = 0), where sinc = 1 and the mu
+          // derivative is 0; the selects keep that fix-up branch-free.
+          for (size_t k = 0; k < N; k++)
+          {
+            const T x = static_cast<T>(k) - half - mu;
+            const T pz = static_cast<T>(M_PI) * x * beta;
+            const bool centre = (pz == T(0));
+            const T sn = std::sin(pz);
+            const T cs = std::cos(pz);
+            const T s = centre ? T(1) : sn / pz;
+            g1[k] = s;
+            g2[k] = centre ? T(0) : finite_or_zero(A * (s - cs) / x);
+            g3[k] = finite_or_zero(A * (cs - s) / beta);
+            r[k] = y[k] - A * s;
+          }
+
+          // J'J (symmetric) and J'r
+          T m00 = 0, m01 = 0, m02 = 0, m11 = 0, m12 = 0, m22 = 0;
+          T b0 = 0, b1 = 0, b2 = 0;
+          for (size_t k = 0; k < N; k++)
+          {
+            m00 += g1[k] * g1[k];
+            m01 += g1[k] * g2[k];
+            m02 += g1[k] * g3[k];
+            m11 += g2[k] * g2[k];
+            m12 += g2[k] * g3[k];
+            m22 += g3[k] * g3[k];
+            b0 += g1[k] * r[k];
+            b1 += g2[k] * r[k];
+            b2 += g3[k] * r[k];
+          }
+
+          std::array<T, 3> delta;
+          if (!solve3(m00, m01, m02, m11, m12, m22, b0, b1, b2, delta))
+            break;
+
+          lambda[0] += delta[0];
+          lambda[1] += delta[1];
+          lambda[2] += delta[2];
+        }
+      }
+
+    private:
+      static T finite_or_zero(T v) { return std::isfinite(v) ? v : T(0); }
+
+      // Closed-form symmetric 3x3 solve (adjugate / determinant)
+      static bool solve3(T m00, T m01, T m02, T m11, T m12, T m22,
+                         T b0, T b1, T b2, std::array<T, 3> &d)
+      {
+        const T c00 = m11 * m22 - m12 * m12;
+        const T c01 = m02 * m12 - m01 * m22;
+        const T c02 = m01 * m12 - m02 * m11;
+        const T c11 = m00 * m22 - m02 * m02;
+        const T c12 = m01 * m02 - m00 * m12;
+        const T c22 = m00 * m11 - m01 * m01;
+        const T det = m00 * c00 + m01 * c01 + m02 * c02;
+
+        const T scale = std::abs(m00 * m11 * m22) + std::abs(det);
+        if (!std::isfinite(det) || std::abs(det) <= std::numeric_limits<T>::epsilon() * scale)
+          return false;
+
+        const T inv = T(1) / det;
+        d[0] = (c00 * b0 + c01 * b1 + c02 * b2) * inv;
+        d[1] = (c01 * b0 + c11 * b1 + c12 * b2) * inv;
+        d[2] = (c02 * b0 + c12 * b1 + c22 * b2) * inv;
+        return std::isfinite(d[0]) && std::isfinite(d[1]) && std::isfinite(d[2]);
+      }
+    };
+
+    /*
+     * Dispatch a runtime point count onto the fixed-size solver. Returns
+     * false if n has no instantiation (even, < 3 or > 31).
+     */
+    template <typename T>
+    bool sinc_nlls_fit(const T *y, size_t n, std::array<T, 3> &lambda, int iters)
+    {
+      switch (n)
+      {
+      case 3:
+        sinc_nlls<T, 3>::fit(y, lambda, iters);
+        return true;
+      case 5:
+        sinc_nlls<T, 5>::fit(y, lambda, iters);
+        return true;
+      case 7:
+        sinc_nlls<T, 7>::fit(y, lambda, iters);
+        return true;
+      case 9:
+        sinc_nlls<T, 9>::fit(y, lambda, iters);
+        return true;
+      case 11:
+        sinc_nlls<T, 11>::fit(y, lambda, iters);
+        return true;
+      case 13:
+        sinc_nlls<T, 13>::fit(y, lambda, iters);
+        return true;
+      case 15:
+        sinc_nlls<T, 15>::fit(y, lambda, iters);
+        return true;
+      case 17:
+        sinc_nlls<T, 17>::fit(y, lambda, iters);
+        return true;
+      case 19:
+        sinc_nlls<T, 19>::fit(y, lambda, iters);
+        return true;
+      case 21:
+        sinc_nlls<T, 21>::fit(y, lambda, iters);
+        return true;
+      case 23:
+        sinc_nlls<T, 23>::fit(y, lambda, iters);
+        return true;
+      case 25:
+        sinc_nlls<T, 25>::fit(y, lambda, iters);
+        return true;
+      case 27:
+        sinc_nlls<T, 27>::fit(y, lambda, iters);
+        return true;
+      case 29:
+        sinc_nlls<T, 29>::fit(y, lambda, iters);
+        return true;
+      case 31:
+        sinc_nlls<T, 31>::fit(y, lambda, iters);
+        return true;
+      default:
+        return false;
+      }
+    }
+
+  } // namespace harmonia
+} // namespace gr
+
+#endif /* INCLUDED_HARMONIA_SINC_NLLS_H */
@@ -21,39 +21,18 @@ namespace gr
           frequency, center_freq, phase, pulse_width, samp_rate, prf, sdr_id);
     }
 
-    af::array single_tone(double frequency, double center_freq, double phase, double pulse_width,
-                          double samp_rate, double prf, double alpha_hat = 1.0)
+    // Tone pulse train written straight into a PDU vector:
+    // phase(t) = 2*pi*f*t/alpha + phase + 2*pi*fc*(1/alpha - 1)*t
+    pmt::pmt_t single_tone(double frequency, double center_freq, double phase, double pulse_width,
+                           double samp_rate, double prf, double alpha_hat = 1.0)
     {
-      double ts = 1 / samp_rate;
-      size_t n_samp_pulse = round(samp_rate * pulse_width);
+      const pulse_layout layout = pulse_train_layout(samp_rate, pulse_width, prf, 0);
+      gr_complex *pulse = nullptr;
+      pmt::pmt_t data = make_pulse_train(layout, &pulse);
 
-      // Time vector
-      af::array t = af::range(af::dim4(n_samp_pulse), -1, f64) * ts;
-
-      // Waveform + Correction
-      af::array phase_term = af::Im * (2 * M_PI * frequency * (t / alpha_hat) + phase);
-      af::array correction_term = af::Im * (2 * M_PI * center_freq * ((1 / alpha_hat) - 1) * t);
-      af::array x = af::exp(phase_term + correction_term);
-
-      // PRF zero padding
-      if (prf > 0)
-      {
-        size_t n_samp_pri = round(samp_rate / prf);
-        size_t n_pad = n_samp_pri - n_samp_pulse;
-        af::array zeros = af::constant(af::cdouble(0, 0), af::dim4(n_pad));
-        x = af::join(0, x, zeros);
-      }
-
-      // // Buffer correction
-      // size_t remainder = x.elements() % max_buffer_size;
-      // if (remainder != 0)
-      // {
-      //   size_t pad = max_buffer_size - remainder;
-      //   af::array pad_arr = af::constant(af::cdouble(0, 0), af::dim4(pad));
-      //   x = af::join(0, x, pad_arr);
-      // }
-
-      return x;
+      const double a = (frequency / alpha_hat + center_freq * ((1 / alpha_hat) - 1)) / samp_rate;
+      quadratic_phase(pulse, layout.pulse, a, 0.0, phase);
+      return data;
     }
 
     /*
@@ -73,10 +52,7 @@ namespace gr
           prf(prf),
           sdr_id(sdr_id)
     {
-      af::array waveform = single_tone(frequency, center_freq, phase, pulse_width, samp_rate, prf).as(c32);
-
-      d_data = pmt::init_c32vector(
-          waveform.elements(), reinterpret_cast<gr_complex *>(waveform.host<af::cfloat>()));
+      d_data = single_tone(frequency, center_freq, phase, pulse_width, samp_rate, prf);
 
       message_port_register_in(msg_port);
       message_port_register_out(out_port);
@@ -147,14 +123,8 @@ namespace gr
       alpha_hat = pmt::to_double(val);
 
       // Generate waveform with corrected drift
-      af::array waveform = single_tone(
-                               frequency, center_freq, phase, pulse_width,
-                               samp_rate, prf, alpha_hat)
-                               .as(c32);
-
-      d_data = pmt::init_c32vector(
-          waveform.elements(),
-          reinterpret_cast<gr_complex *>(waveform.host<af::cfloat>()));
+      d_data = single_tone(frequency, center_freq, phase, pulse_width,
+                           samp_rate, prf, alpha_hat);
 
       // Update outgoing metadata with original + SDR-specific value
       if (sdr_id == 1)
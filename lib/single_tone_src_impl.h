@@ -12,6 +12,7 @@
 #include <gnuradio/harmonia/pmt_constants.h>
 #include <arrayfire.h>
 #include <plasma_dsp/pulsed_waveform.h>
+#include "pulse_builder.h"
 
 namespace gr
 {
@@ -6,10 +6,12 @@
  */
 
 #include "time_pk_est_impl.h"
+#include "sinc_nlls.h"
 #include <gnuradio/io_signature.h>
 #include <arrayfire.h>
 #include <cmath>
 #include <iomanip>
+#include <limits>
 
 namespace gr
 {
@@ -53,8 +55,15 @@ namespace gr
           NLLS_iter(NLLS_iter),
           sdr_id(sdr_id),
           enable_out(enable_out),
-          d_rx_count(0)
+          d_mf_len(0),
+          d_ols_nfft(0),
+          d_rx_count(0),
+          d_cfar_guard(2),
+          d_cfar_train(16),
+          d_cfar_pfa(1e-6),
+          d_cfar_max_det(0)
     {
+      set_tdma_schedule({1, 2, 3});
       d_data = pmt::make_c32vector(0, 0);
       d_meta = pmt::make_dict();
       d_tp_meta = pmt::make_dict();
@@ -86,12 +95,6 @@ namespace gr
      */
     time_pk_est_impl::~time_pk_est_impl() {}
 
-    // Sinc Function
-    af::array time_pk_est_impl::sinc(const af::array &x)
-    {
-      return af::select(x == 0.0, 1.0, af::sin(M_PI * x) / (M_PI * x));
-    }
-
     void time_pk_est_impl::handle_clock_drift(pmt::pmt_t msg)
     {
       // Validate message is a PDU
@@ -102,23 +105,27 @@ namespace gr
       }
 
       double default_alpha = 1.0;
-      alpha1 = pmt::to_double(pmt::dict_ref(msg, PMT_HARMONIA_SDR1, pmt::from_double(default_alpha)));
-      alpha2 = pmt::to_double(pmt::dict_ref(msg, PMT_HARMONIA_SDR2, pmt::from_double(default_alpha)));
-      alpha3 = pmt::to_double(pmt::dict_ref(msg, PMT_HARMONIA_SDR3, pmt::from_double(default_alpha)));
+      for (int id = 1; id <= d_num_platforms; id++)
+        d_alpha[id - 1] = pmt::to_double(pmt::dict_ref(msg, harmonia_sdr_key("sdr", id), pmt::from_double(default_alpha)));
       // std::cout << std::fixed << std::setprecision(12)
-      // << "alpha1 = " << alpha1 << "\n"
-      // << "alpha2 = " << alpha2 << "\n"
-      // << "alpha3 = " << alpha3 << std::endl;
+      // << "alpha1 = " << d_alpha[0] << std::endl;
     }
 
     void time_pk_est_impl::handle_tx_msg(pmt::pmt_t msg)
     {
       pmt::pmt_t samples;
+      pmt::pmt_t tx_meta = pmt::PMT_NIL;
       if (pmt::is_pdu(msg))
       {
-        // Get the transmit data
+        // Get the transmit data; the matched filter spectrum is consumed
+        // here and kept out of the forwarded metadata
         samples = pmt::cdr(msg);
-        d_meta = pmt::dict_update(d_meta, pmt::car(msg));
+        tx_meta = pmt::car(msg);
+        pmt::pmt_t meta = tx_meta;
+        meta = pmt::dict_delete(meta, PMT_HARMONIA_MF_SPECTRUM);
+        meta = pmt::dict_delete(meta, PMT_HARMONIA_MF_NFFT);
+        meta = pmt::dict_delete(meta, PMT_HARMONIA_MF_LENGTH);
+        d_meta = pmt::dict_update(d_meta, meta);
       }
       else if (pmt::is_uniform_vector(msg))
       {
@@ -133,25 +140,214 @@ namespace gr
       size_t io(0);
       const gr_complex *tx_data = pmt::c32vector_elements(samples, io);
 
-      // Resize the matched filter array if necessary
-      if (d_match_filt.elements() != (int)n)
+      // Reference for the windowed correlation
+      d_tx_ref = af::array(af::dim4(n), reinterpret_cast<const af::cfloat *>(tx_data));
+      d_mf_len = n;
+
+      // Overlap-save block size: next power of two >= 4x the filter length
+      d_ols_nfft = mf_nfft(n);
+
+      // Matched filter spectrum is only rebuilt when the reference changes,
+      // and not at all when the source attached one for this length and
+      // block size
+      pmt::pmt_t H = pmt::PMT_NIL;
+      if (pmt::is_dict(tx_meta) &&
+          pmt::to_long(pmt::dict_ref(tx_meta, PMT_HARMONIA_MF_LENGTH, pmt::from_long(-1))) == (long)n &&
+          pmt::to_long(pmt::dict_ref(tx_meta, PMT_HARMONIA_MF_NFFT, pmt::from_long(-1))) == (long)d_ols_nfft)
+        H = pmt::dict_ref(tx_meta, PMT_HARMONIA_MF_SPECTRUM, pmt::PMT_NIL);
+
+      if (pmt::is_c32vector(H) && pmt::length(H) == (size_t)d_ols_nfft)
       {
-        d_match_filt = af::constant(0, n, c32);
+        size_t len = 0;
+        const gr_complex *h = pmt::c32vector_elements(H, len);
+        d_mf_fft = af::array(af::dim4(d_ols_nfft), reinterpret_cast<const af::cfloat *>(h));
       }
-      // Create the matched filter
-      d_match_filt = af::array(af::dim4(n), reinterpret_cast<const af::cfloat *>(tx_data));
-      d_match_filt = af::conjg(d_match_filt);
-      d_match_filt = af::flip(d_match_filt, 0);
+      else
+      {
+        d_mf_fft = mf_spectrum(d_tx_ref, d_ols_nfft);
+      }
+      d_ols_cache.clear();
+    }
+
+    const time_pk_est_impl::ols_plan &time_pk_est_impl::get_ols_plan(size_t n, size_t num_captures)
+    {
+      auto key = std::make_pair(n, num_captures);
+      auto it = d_ols_cache.find(key);
+      if (it != d_ols_cache.end())
+        return it->second;
+
+      // Each segment yields nfft - L + 1 new outputs of the full linear convolution
+      dim_t L = d_mf_len;
+      dim_t step = d_ols_nfft - L + 1;
+      ols_plan plan;
+      plan.nseg = (n + L - 1 + step - 1) / step;
+      plan.pad_len = (plan.nseg - 1) * step + d_ols_nfft;
+
+      // Column s of the segment matrix starts at s * step of the padded input
+      af::array rows = af::range(af::dim4(d_ols_nfft, plan.nseg), 0, s32);
+      af::array cols = af::range(af::dim4(d_ols_nfft, plan.nseg), 1, s32);
+      plan.seg_idx = af::flat(rows + cols * step);
+      plan.H = af::tile(d_mf_fft, 1, plan.nseg * num_captures);
+
+      return d_ols_cache.emplace(key, plan).first->second;
+    }
+
+    af::array time_pk_est_impl::overlap_save(const af::array &x)
+    {
+      // One capture per column
+      dim_t n = x.dims(0);
+      dim_t K = x.dims(1);
+      dim_t L = d_mf_len;
+      const ols_plan &plan = get_ols_plan(n, K);
+
+      // Prepend L - 1 zeros of history and pad the tail to a whole number of segments
+      af::array xpad = af::constant(0, plan.pad_len, K, c32);
+      xpad(af::seq(L - 1, L + n - 2), af::span) = x;
+      af::array segs = af::moddims(xpad(plan.seg_idx, af::span), d_ols_nfft, plan.nseg * K);
+
+      // Batched circular convolution of every segment of every capture,
+      // discarding the wrapped samples
+      af::array Y = af::ifft(af::fft(segs, d_ols_nfft) * plan.H);
+      Y = Y(af::seq(L - 1, d_ols_nfft - 1), af::span);
+
+      // Full (AF_CONV_EXPAND) response of length n + L - 1 for each capture
+      Y = af::moddims(Y, (d_ols_nfft - L + 1) * plan.nseg, K);
+      return Y(af::seq(0, n + L - 2), af::span);
+    }
+
+    bool time_pk_est_impl::search_window(pmt::pmt_t meta, size_t n, dim_t &lag0, dim_t &n_win)
+    {
+      if (!pmt::is_dict(meta) || !pmt::dict_has_key(meta, PMT_HARMONIA_PRIOR_DELAY) ||
+          !pmt::dict_has_key(meta, PMT_HARMONIA_PRIOR_UNCERTAINTY))
+        return false;
+
+      double prior_delay = pmt::to_double(pmt::dict_ref(meta, PMT_HARMONIA_PRIOR_DELAY, pmt::PMT_NIL));
+      double prior_unc = pmt::to_double(pmt::dict_ref(meta, PMT_HARMONIA_PRIOR_UNCERTAINTY, pmt::PMT_NIL));
+
+      // Invert t_pk = (idx / fs) / alpha - wait_time - sample_delay / fs, and
+      // widen by the NLLS half-width so the refinement points stay inside
+      double center = (prior_delay + wait_time + sample_delay / samp_rate) * alpha_hat * samp_rate;
+      double half = std::ceil(std::abs(prior_unc) * alpha_hat * samp_rate) + 3.0;
+
+      // The full response holds lags 0 .. n - 2
+      double lo = std::max(std::floor(center - half), 0.0);
+      double hi = std::min(std::ceil(center + half), static_cast<double>(n) - 2.0);
+      if (!(hi >= lo))
+        return false;
+
+      lag0 = static_cast<dim_t>(lo);
+      n_win = static_cast<dim_t>(hi - lo) + 1;
+      return true;
+    }
+
+    af::array time_pk_est_impl::windowed_correlation(const af::array &x, dim_t lag0, dim_t n_win)
+    {
+      dim_t n = x.dims(0);
+      dim_t K = x.dims(1);
+      dim_t L = d_tx_ref.elements();
+
+      // Column w of the window matrix holds the L input samples seen by the
+      // matched filter at response index lag0 + w (zero past the capture end)
+      af::array xpad = af::join(0, x, af::constant(0, L, K, c32));
+      af::array rows = af::range(af::dim4(L, n_win), 0, s32);
+      af::array cols = af::range(af::dim4(L, n_win), 1, s32);
+      af::array win_idx = af::flat(rows + cols + static_cast<int>(lag0 + 1));
+      af::array X = af::moddims(xpad(win_idx, af::span), L, n_win * K);
+
+      // One dot product per lag: tx^H * X
+      af::array r = af::matmul(d_tx_ref, X, AF_MAT_CTRANS, AF_MAT_NONE);
+      return af::moddims(r, n_win, K);
+    }
+
+    af::array time_pk_est_impl::cfar_detect(const af::array &resp_abs)
+    {
+      dim_t n_resp = resp_abs.dims(0);
+      dim_t K = resp_abs.dims(1);
+      int G = d_cfar_guard;
+      int T = d_cfar_train;
+
+      // Sliding-window sums from one cumulative sum: sum(P[a..b)) = C[b] - C[a]
+      af::array P = af::pow(resp_abs.as(f64), 2);
+      af::array C = af::join(0, af::constant(0, 1, K, f64), af::accum(P, 0));
+
+      // Training cells [i-G-T, i-G) and (i+G, i+G+T], clipped to the response
+      af::array i = af::range(af::dim4(n_resp), 0, s32);
+      double hi = static_cast<double>(n_resp);
+      af::array lo1 = af::clamp(i - G - T, 0.0, hi);
+      af::array hi1 = af::clamp(i - G, 0.0, hi);
+      af::array lo2 = af::clamp(i + G + 1, 0.0, hi);
+      af::array hi2 = af::clamp(i + G + T + 1, 0.0, hi);
+      af::array noise = (C(hi1, af::span) - C(lo1, af::span)) + (C(hi2, af::span) - C(lo2, af::span));
+      // (1.0, not 1: the int overload is a reduction along dimension 1)
+      af::array cnt = af::max((hi1 - lo1) + (hi2 - lo2), 1.0).as(f64);
+
+      // CA-CFAR scale for the number of training cells actually used
+      af::array alpha = cnt * (af::pow(d_cfar_pfa, -1.0 / cnt) - 1.0);
+      af::array thresh = af::tile(alpha / cnt, 1, K) * noise;
+
+      // Threshold crossings that are also local maxima
+      af::array det = (P > thresh) &
+                      (P >= af::shift(P, 1)) &
+                      (P > af::shift(P, -1));
+      det(0, af::span) = 0;
+      det(af::end, af::span) = 0;
+
+      // Keep the first max_det detections of each capture
+      af::array rank = af::accum(det.as(s32), 0);
+      return af::where(det && (rank <= d_cfar_max_det));
+    }
+
+    af::array time_pk_est_impl::gather_peaks(const af::array &resp,
+                                             const af::array &resp_abs,
+                                             const af::array &lin_idx)
+    {
+      dim_t n_resp = resp.dims(0);
+      dim_t M = lin_idx.elements();
+      af::array lin = af::moddims(lin_idx.as(s32), 1, M);
+      af::array lag = af::mod(lin, static_cast<int>(n_resp));
+      af::array col_start = lin - lag;
+
+      // NLLS points around each peak, clamped to the peak's own capture
+      af::array off = af::range(af::dim4(nlls_pts, M), 0, s32) - (nlls_pts - 1) / 2;
+      af::array nbhd = af::clamp(af::tile(lag, nlls_pts) + off, 0.0, static_cast<double>(n_resp - 1));
+      nbhd = nbhd + af::tile(col_start, nlls_pts);
+
+      af::array peak = af::moddims(resp(af::flat(lin)), 1, M);
+      return af::join(0,
+                      lin.as(f64),
+                      af::join(0, af::real(peak), af::imag(peak)).as(f64),
+                      af::moddims(resp_abs(af::flat(nbhd)), nlls_pts, M).as(f64));
+    }
+
+    double time_pk_est_impl::refine_peak(const double *col, size_t max_idx, double &phase)
+    {
+      double max_val = col[3 + (nlls_pts - 1) / 2];
+
+      // Phase Estimates
+      phase = static_cast<float>(std::atan2(col[2], col[1]));
+      // std::cout << "Phase: " << phase << std::endl;
+
+      // Time of the peak sample
+      double t_pk = (max_idx / samp_rate) / alpha_hat - (wait_time) - (sample_delay / samp_rate);
+      // std::cout << std::setprecision(15) << "t_pk = " << t_pk << "sdr: " << sdr_id << std::endl;
+      // std::cout << "max_idx = " << max_idx << "sdr: " << sdr_id << std::endl;
+      // ----------------- Sinc-NLLS -----------------
+      // lambda = {amplitude, peak offset (samples), sinc width}
+      std::array<double, 3> lambda = {max_val, 0.0, bandwidth / samp_rate};
+      sinc_nlls<double, nlls_pts>::fit(col + 3, lambda, static_cast<int>(NLLS_iter));
+
+      // Compute time estimate
+      return t_pk + (lambda[1] / samp_rate);
     }
 
     void time_pk_est_impl::handle_rx_msg(pmt::pmt_t msg)
     {
-      if (this->nmsgs(d_rx_port) > d_msg_queue_depth or d_match_filt.elements() == 0)
+      if (this->nmsgs(d_rx_port) > d_msg_queue_depth or d_mf_len == 0)
       {
         return;
       }
       // Check for incoming receiving data
-      pmt::pmt_t samples, meta;
+      pmt::pmt_t samples, meta = pmt::PMT_NIL;
       if (pmt::is_pdu(msg))
       {
         meta = pmt::car(msg);
@@ -168,216 +364,198 @@ namespace gr
         return;
       }
 
-      // Set SDR PMT
-      switch (sdr_id)
+      // Transmitter of the current TDMA slot
+      if (d_rx_slot_tx.empty() || sdr_id < 1 || sdr_id > d_num_platforms)
       {
-      case 1:
-        sdr_pmt = PMT_HARMONIA_SDR1;
-        if (d_rx_count == 0)
-          wire_delay = 1.4e-9;
-        else
-          wire_delay = 1.4e-9;
-        alpha_hat = alpha1;
-        break;
-      case 2:
-        sdr_pmt = PMT_HARMONIA_SDR2;
-        if (d_rx_count == 0)
-          wire_delay = 1.4e-9;
-        else
-          wire_delay = 1.4e-9;
-        alpha_hat = alpha2;
-        break;
-      case 3:
-        sdr_pmt = PMT_HARMONIA_SDR3;
-        if (d_rx_count == 0)
-          wire_delay = 1.4e-9;
-        else
-          wire_delay = 1.4e-9;
-        alpha_hat = alpha3;
-        break;
+        GR_LOG_WARN(d_logger, "Platform " + std::to_string(sdr_id) + " is not in the TDMA schedule");
+        return;
       }
+      int tx_id = d_rx_slot_tx[d_rx_count];
+      sdr_pmt = harmonia_sdr_key("sdr", sdr_id);
+      alpha_hat = d_alpha[sdr_id - 1];
+
+      // Number of stacked captures in the payload (one per column)
+      size_t num_captures = 1;
+      if (pmt::is_dict(meta) && pmt::dict_has_key(meta, PMT_HARMONIA_NUM_CAPTURES))
+        num_captures = pmt::to_long(pmt::dict_ref(meta, PMT_HARMONIA_NUM_CAPTURES, pmt::from_long(1)));
 
       // Compute matrix and vector dimensions
-      size_t n = pmt::length(samples);
+      size_t n_total = pmt::length(samples);
+      if (num_captures == 0 || n_total % num_captures != 0)
+      {
+        GR_LOG_WARN(d_logger, "Payload length " + std::to_string(n_total) +
+                                  " is not a multiple of num_captures = " + std::to_string(num_captures));
+        return;
+      }
+      size_t n = n_total / num_captures;
+      dim_t K = static_cast<dim_t>(num_captures);
       // std::cout << "Length of rx'd waveform length = " << n << std::endl;
 
-      size_t nconv = n + d_match_filt.elements() - 1;
-      size_t mf_n = d_match_filt.elements();
-      if (pmt::length(d_data) != n)
-        d_data = pmt::make_c32vector(nconv, 0);
+      size_t mf_n = d_mf_len;
 
       // Get input and output data
       size_t io(0);
       const gr_complex *in = pmt::c32vector_elements(samples, io);
 
-      // Apply the matched filter
-      af::array mf_resp(af::dim4(n), reinterpret_cast<const af::cfloat *>(in));
-      mf_resp = af::convolve1(mf_resp, d_match_filt, AF_CONV_EXPAND, AF_CONV_AUTO);
-      // std::cout << "Length of mf_resp before = " << mf_resp.elements() << std::endl;
-      mf_resp = mf_resp(af::seq(mf_n, af::end));
-      // std::cout << "Length of mf_resp after = " << mf_resp.elements() << std::endl;
-      // af::array mf_resp_abs = af::abs(mf_resp);
-      // mf_resp_abs = mf_resp_abs.as(f64);
-
-      std::vector<std::complex<float>> host(mf_resp.elements());
-      mf_resp.host(host.data());
+      af::array rx_data(af::dim4(n, K), reinterpret_cast<const af::cfloat *>(in));
 
-      std::vector<float> mags(host.size());
-      for (size_t i = 0; i < host.size(); i++)
+      // Only correlate the lags around the prior peak location when one is
+      // given, otherwise apply the matched filter over the whole capture
+      dim_t lag0 = 0;
+      dim_t n_win = 0;
+      bool windowed = search_window(meta, n, lag0, n_win);
+      af::array mf_resp;
+      if (windowed)
       {
-        mags[i] = std::abs(host[i]);
+        mf_resp = windowed_correlation(rx_data, lag0, n_win);
       }
-      af::array mf_resp_abs(mf_resp.dims(), mags.data());
-      af::array mf_resp_abs_f64 = mf_resp_abs.as(f64);
-
-      // COMPLEX OUTPUT
-      d_data = pmt::make_c32vector(nconv, gr_complex{0, 0});
-      size_t out_io = 0;
-      gr_complex *out = pmt::c32vector_writable_elements(d_data, out_io);
-      mf_resp.host(reinterpret_cast<af::cfloat *>(out));
+      else
+      {
+        // Apply the matched filter to every capture in one batch
+        mf_resp = overlap_save(rx_data);
+        // std::cout << "Length of mf_resp before = " << mf_resp.elements() << std::endl;
+        mf_resp = mf_resp(af::seq(mf_n, af::end), af::span);
+        // std::cout << "Length of mf_resp after = " << mf_resp.elements() << std::endl;
+      }
+      dim_t n_resp = mf_resp.dims(0);
 
+      // COMPLEX OUTPUT (only copied to the host when it is published): the
+      // n_resp x K responses, one capture after the other
       if (enable_out)
       {
+        d_data = pmt::make_c32vector(mf_resp.elements(), gr_complex{0, 0});
+        size_t out_io = 0;
+        gr_complex *out = pmt::c32vector_writable_elements(d_data, out_io);
+        mf_resp.host(reinterpret_cast<af::cfloat *>(out));
         message_port_pub(d_out_port, pmt::cons(d_meta, d_data));
       }
 
-      // Output max and index of data
-      double max_val = 0.0;
-      unsigned max_idx = 0;
-      af::max(&max_val, &max_idx, mf_resp_abs_f64);
-
-      // Phase Estimates
-      af::array complex_peak = mf_resp_abs(max_idx);
-      af::array phase = af::arg(complex_peak);
-      float p_est = phase.scalar<float>();
-      // std::cout << "Phase: " << p_est << std::endl;
-
-      // Generate time axis
-      af::array t = ((af::seq(0, nconv - 1)) * 1.0 / samp_rate)/alpha_hat;
-      t = t.as(f64);
-
-      af::array t_pk = t(max_idx) - (wait_time) - (sample_delay / samp_rate);
-      t_pk = t_pk.as(f64);
-      // af_print(t_pk);
-      // float t_pk_val = t_pk.scalar<float>();
-      // std::cout << std::setprecision(15) << "t_pk = " << t_pk_val << "sdr: " << sdr_id << std::endl;
-      // std::cout << "max_idx = " << max_idx << "sdr: " << sdr_id << std::endl;
-      // ----------------- Sinc-NLLS -----------------
-      // Create lambda array
-      double lambda[] = {max_val, 0.0, bandwidth / samp_rate};
-      af::array af_lambda(3, lambda, afHost);
-      af_lambda = af_lambda.as(f64);
-      // af_print(af_lambda);
-      // Making Index for NLLS
-      double NLLS_pts = std::ceil(2.0 * samp_rate / bandwidth) - 1.0;
-      // GR_LOG_INFO(d_logger, "NLLS Points: " + std::to_string(NLLS_pts));
-
-      // Minimum Number of Points = 5
-      if (NLLS_pts != 5.0)
-        NLLS_pts = 5.0;
-      // GR_LOG_INFO(d_logger, "NLLS Points: " + std::to_string(NLLS_pts));
-
-      // NLLS Index Vector
-      af::array nlls_ind = af::seq(0.0, NLLS_pts - 1.0);
-      nlls_ind = nlls_ind - af::median(nlls_ind);
-      nlls_ind = nlls_ind.as(f64);
-      // af_print(nlls_ind);
-
-      af::array max_vector = af::constant(static_cast<double>(max_idx), static_cast<dim_t>(NLLS_pts));
-      // af_print(max_vector);
-
-      // Output vector of points around max index
-      af::array nlls_y = mf_resp_abs(max_vector - nlls_ind);
-      nlls_y = af::abs(nlls_y);
-      nlls_y = af::flip(nlls_y, 0);
-      nlls_y = nlls_y.as(f64);
-      // af_print(nlls_y);
-
-      // Iterates through NLLS x times
-      for (int i = 0; i < NLLS_iter; i++)
+      // Magnitude and peak search stay on the device (argmax along the delay axis)
+      af::array mf_resp_abs = af::abs(mf_resp);
+      af::array max_arr, idx_arr;
+      af::max(max_arr, idx_arr, mf_resp_abs, 0);
+
+      // Linear indices of the strongest peak of each capture, followed by the
+      // first CFAR detections of each capture (sorted by capture, then lag)
+      af::array col_off = af::range(af::dim4(1, K), 1, s32) * n_resp;
+      af::array peak_idx = af::flat(idx_arr.as(s32) + col_off);
+      size_t n_det = 0;
+      if (d_cfar_max_det > 0)
       {
-        af::array x = nlls_ind - af_lambda(1);
-        af::array z = x * af_lambda(2);
-        af::array sinc_z = sinc(z);
-        af::array cos_z = af::cos(af::Pi * z);
-        af::array nlls_f = af_lambda(0) * sinc_z;
-        // Jacobian Matrix
-        af::array GN1 = sinc_z;
-        af::array GN2 = af_lambda(0) * (sinc_z - cos_z) / (x);
-        af::array GN3 = af_lambda(0) * x * (cos_z - sinc_z) / af_lambda(2);
-        af::array J = af::join(1, GN1, GN2, GN3);
-        J = J.as(f64);
-        // Replace Infinite and NaNs with zeros
-        af::replace(J, !(af::isInf(J)), 0.0);
-        af::replace(J, !(af::isNaN(J)), 0.0);
-
-        // Residual
-        af::array r = (nlls_y - nlls_f);
-        // Solve for lambda
-        af::array JTJ = af::matmulTN(J, J);
-        af::array JTr = af::matmulTN(J, r);
-        af::array delta = af::solve(JTJ, JTr);
-        delta = delta.as(f64);
-        // af::array delta = af::matmul((af::matmul((af::inverse(af::matmul(J.T(), J))), J.T())), r);
-
-        // af::array Q,R;
-        // af::qr(Q,R,J);
-        // af::array y_ls = af::matmulTN(Q,r);
-        // af::array delta = af::solve(R,y_ls,AF_MAT_UPPER);
-
-        af_lambda += delta;
+        af::array det_idx = cfar_detect(mf_resp_abs);
+        n_det = det_idx.elements();
+        if (n_det > 0)
+          peak_idx = af::join(0, peak_idx, det_idx.as(s32));
       }
-      // Output Lambda
-      af_lambda.host(lambda);
 
-      // Compute frequency estimate
-      af::array t_est_arr = t_pk + (af_lambda(1) / samp_rate);
-      // af_print(t_est_arr);
-      // Extract scalar value from ArrayFire array
-      t_est_arr.host(&t_est);
+      // Lag each capture reports: its earliest CFAR detection (the direct
+      // path), else the strongest peak
+      af::array ref_lag = idx_arr.as(s32);
+      if (n_det > 0)
+      {
+        af::array first = af::constant(static_cast<int>(n_resp), n_resp, K, s32);
+        first(det_idx) = af::mod(det_idx.as(s32), static_cast<int>(n_resp));
+        first = af::min(first, 0);
+        ref_lag = af::select(first < n_resp, first, ref_lag);
+      }
 
-      if (d_rx_count < 2)
+      // Link quality from the same response: noise floor and strongest
+      // sidelobe outside the mainlobes (first sinc null) of the reported and
+      // the strongest peak, plus the number of lags the noise averages over
+      int mainlobe_half = static_cast<int>(std::ceil(samp_rate / bandwidth));
+      af::array lag = af::range(af::dim4(n_resp, K), 0, s32);
+      af::array mainlobe = (af::abs(lag - af::tile(ref_lag, n_resp)) <= mainlobe_half) ||
+                           (af::abs(lag - af::tile(idx_arr.as(s32), n_resp)) <= mainlobe_half);
+      af::array P_side = af::select(mainlobe, 0.0, af::pow(mf_resp_abs.as(f64), 2));
+      af::array n_side = static_cast<double>(n_resp) - af::count(mainlobe, 0).as(f64);
+      af::array quality = af::join(0, af::sum(P_side, 0) / af::max(n_side, 1.0),
+                                   af::max(P_side, 0), n_side);
+
+      // Single download, one column per peak:
+      // [linear index, Re/Im of the complex peak, NLLS magnitudes],
+      // followed by [noise power, peak sidelobe power, sidelobe lags] per
+      // capture
+      af::array peaks = gather_peaks(mf_resp, mf_resp_abs, peak_idx);
+      af::array packed = af::join(0, af::flat(peaks), af::flat(quality));
+      const size_t stride = 3 + nlls_pts;
+      std::vector<double> peak_host(packed.elements());
+      packed.host(peak_host.data());
+      const double *quality_host = peak_host.data() + peaks.elements();
+
+      // Column of the peak each capture reports
+      std::vector<size_t> ref_col(num_captures);
+      std::vector<double> t_ests(num_captures);
+      std::vector<double> p_ests(num_captures);
+      std::vector<bool> has_det(num_captures, false);
+      std::vector<double> cfar_ests;
+      cfar_ests.reserve(n_det);
+      for (size_t d = 0; d < n_det; d++)
       {
-        switch (sdr_id)
+        const double *col = peak_host.data() + (num_captures + d) * stride;
+        size_t k = static_cast<size_t>(col[0]) / n_resp;
+        double p_det;
+        double t_det = refine_peak(col, static_cast<size_t>(col[0]) % n_resp + lag0, p_det);
+        cfar_ests.push_back(t_det);
+
+        // The earliest detection of each capture is the direct path
+        if (!has_det[k])
         {
-        case 1:
-          if (d_rx_count == 0)
-          {
-            d_sdr2_time_est.push_back(t_est);
-            d_sdr2_phase_est.push_back(p_est);
-          }
-          else
-          {
-            d_sdr3_time_est.push_back(t_est);
-            d_sdr3_phase_est.push_back(p_est);
-          }
-          break;
-        case 2:
-          if (d_rx_count == 0)
-          {
-            d_sdr1_time_est.push_back(t_est);
-            d_sdr1_phase_est.push_back(p_est);
-          }
-          else
-          {
-            d_sdr3_time_est.push_back(t_est);
-            d_sdr3_phase_est.push_back(p_est);
-          }
-          break;
-        case 3:
-          if (d_rx_count == 0)
-          {
-            d_sdr1_time_est.push_back(t_est);
-            d_sdr1_phase_est.push_back(p_est);
-          }
-          else
-          {
-            d_sdr2_time_est.push_back(t_est);
-            d_sdr2_phase_est.push_back(p_est);
-          }
-          break;
+          has_det[k] = true;
+          ref_col[k] = num_captures + d;
+          t_ests[k] = t_det;
+          p_ests[k] = p_det;
+        }
+      }
+      for (size_t k = 0; k < num_captures; k++)
+      {
+        // Fall back to the strongest peak when CFAR is off or found nothing
+        if (has_det[k])
+          continue;
+        ref_col[k] = k;
+        const double *col = peak_host.data() + k * stride;
+        t_ests[k] = refine_peak(col, static_cast<size_t>(col[0]) % n_resp + lag0, p_ests[k]);
+      }
+      t_est = t_ests.back();
+      p_est = p_ests.back();
+
+      // SNR and PSLR of the reported peak, and the delay CRLB
+      // var = 3 / (2 pi^2 B^2 SNR) for a flat spectrum of width B. A narrow
+      // search window can leave (almost) no lags outside the mainlobe; the
+      // noise floor is then unknown and the metrics are NaN, which the
+      // solvers treat as not reported.
+      const double min_side_lags = 16.0;
+      std::vector<double> snr(num_captures);
+      std::vector<double> pslr(num_captures);
+      std::vector<double> var(num_captures);
+      for (size_t k = 0; k < num_captures; k++)
+      {
+        const double *q = quality_host + 3 * k;
+        if (q[2] < min_side_lags)
+        {
+          snr[k] = pslr[k] = var[k] = std::numeric_limits<double>::quiet_NaN();
+          continue;
         }
+        const double *col = peak_host.data() + ref_col[k] * stride;
+        double peak_pw = col[1] * col[1] + col[2] * col[2];
+        double snr_lin = peak_pw / std::max(q[0], std::numeric_limits<double>::min());
+        snr[k] = 10.0 * std::log10(snr_lin);
+        pslr[k] = 10.0 * std::log10(peak_pw / std::max(q[1], std::numeric_limits<double>::min()));
+        var[k] = 3.0 / (2.0 * M_PI * M_PI * bandwidth * bandwidth * snr_lin);
       }
+
+      auto append = [](std::vector<double> &dst, const std::vector<double> &src)
+      {
+        dst.insert(dst.end(), src.begin(), src.end());
+      };
+
+      // Fill this platform's row of the (tx, rx) table
+      link_est &link = d_table[table_index(tx_id, sdr_id)];
+      append(link.time, t_ests);
+      append(link.phase, p_ests);
+      append(link.cfar, cfar_ests);
+      append(link.snr, snr);
+      append(link.pslr, pslr);
+      append(link.var, var);
       d_rx_count++;
 
       auto to_pmt_f64 = [&](const std::vector<double> &v)
@@ -385,14 +563,26 @@ namespace gr
         return pmt::init_f64vector(v.size(), const_cast<double *>(v.data()));
       };
 
-      if (d_rx_count == 2)
+      // Publish as soon as every transmitter of the schedule has been heard
+      if (d_rx_count == static_cast<int>(d_rx_slot_tx.size()))
       {
-        d_tp_meta = pmt::dict_add(d_tp_meta, PMT_HARMONIA_SDR1, to_pmt_f64(d_sdr1_time_est));
-        d_tp_meta = pmt::dict_add(d_tp_meta, PMT_HARMONIA_P_SDR1, to_pmt_f64(d_sdr1_phase_est));
-        d_tp_meta = pmt::dict_add(d_tp_meta, PMT_HARMONIA_SDR2, to_pmt_f64(d_sdr2_time_est));
-        d_tp_meta = pmt::dict_add(d_tp_meta, PMT_HARMONIA_P_SDR2, to_pmt_f64(d_sdr2_phase_est));
-        d_tp_meta = pmt::dict_add(d_tp_meta, PMT_HARMONIA_SDR3, to_pmt_f64(d_sdr3_time_est));
-        d_tp_meta = pmt::dict_add(d_tp_meta, PMT_HARMONIA_P_SDR3, to_pmt_f64(d_sdr3_phase_est));
+        for (int tx = 1; tx <= d_num_platforms; tx++)
+        {
+          link_est &l = d_table[table_index(tx, sdr_id)];
+          d_tp_meta = pmt::dict_add(d_tp_meta, harmonia_sdr_key("sdr", tx), to_pmt_f64(l.time));
+          d_tp_meta = pmt::dict_add(d_tp_meta, harmonia_sdr_key("phase_sdr", tx), to_pmt_f64(l.phase));
+          // Quality keys go out for every link, NaN where there is none,
+          // so a consumer never falls back to an older report's values
+          if (tx != sdr_id)
+          {
+            d_tp_meta = pmt::dict_add(d_tp_meta, harmonia_sdr_key("snr_sdr", tx), to_pmt_f64(l.snr));
+            d_tp_meta = pmt::dict_add(d_tp_meta, harmonia_sdr_key("pslr_sdr", tx), to_pmt_f64(l.pslr));
+            d_tp_meta = pmt::dict_add(d_tp_meta, harmonia_sdr_key("var_sdr", tx), to_pmt_f64(l.var));
+          }
+          if (!l.cfar.empty())
+            d_tp_meta = pmt::dict_add(d_tp_meta, harmonia_sdr_key("cfar_sdr", tx), to_pmt_f64(l.cfar));
+          l = link_est();
+        }
         d_tp_meta = pmt::dict_add(d_tp_meta, pmt::intern("rx_id"), sdr_pmt);
 
         // Send the time estimates as a message with metadata
@@ -401,6 +591,7 @@ namespace gr
 
         // Now publish that PDU:
         message_port_pub(d_tp_out_port, pdu);
+        d_rx_count = 0;
       }
 
       // Reset the metadata output
@@ -409,6 +600,49 @@ namespace gr
 
     void time_pk_est_impl::set_msg_queue_depth(size_t depth) { d_msg_queue_depth = depth; }
 
+    void time_pk_est_impl::set_tdma_schedule(const std::vector<int> &slot_tx)
+    {
+      int num_platforms = 0;
+      for (int tx : slot_tx)
+      {
+        if (tx < 1)
+        {
+          GR_LOG_WARN(d_logger, "TDMA schedule entries must be platform numbers >= 1");
+          return;
+        }
+        num_platforms = std::max(num_platforms, tx);
+      }
+      num_platforms = std::max(num_platforms, sdr_id);
+
+      d_slot_tx = slot_tx;
+      d_num_platforms = num_platforms;
+
+      // Slots in which this platform listens, in reception order
+      d_rx_slot_tx.clear();
+      for (int tx : d_slot_tx)
+        if (tx != sdr_id)
+          d_rx_slot_tx.push_back(tx);
+
+      size_t cells = static_cast<size_t>(d_num_platforms) * d_num_platforms;
+      d_table.assign(cells, link_est());
+      d_alpha.assign(d_num_platforms, 1.0);
+      d_rx_count = 0;
+    }
+
+    void time_pk_est_impl::set_cfar(int guard_cells, int train_cells, double pfa, int max_detections)
+    {
+      if (train_cells < 1 || guard_cells < 0 || pfa <= 0.0 || pfa >= 1.0)
+      {
+        GR_LOG_WARN(d_logger, "Invalid CFAR parameters, detection disabled");
+        d_cfar_max_det = 0;
+        return;
+      }
+      d_cfar_guard = guard_cells;
+      d_cfar_train = train_cells;
+      d_cfar_pfa = pfa;
+      d_cfar_max_det = std::max(max_detections, 0);
+    }
+
     void time_pk_est_impl::set_backend(Device::Backend backend)
     {
       switch (backend)
@@ -11,11 +11,14 @@
 #include <gnuradio/harmonia/device.h>
 #include <gnuradio/harmonia/time_pk_est.h>
 #include <gnuradio/harmonia/pmt_constants.h>
+#include "matched_filter.h"
 #include <plasma_dsp/fft.h>
 #include <arrayfire.h>
 #include <cmath>
 #include <algorithm>
 #include <array>
+#include <map>
+#include <utility>
 #include <vector>
 #include <complex>
 #include <stdexcept>
@@ -35,25 +38,50 @@ namespace gr
       double sample_delay;
       double NLLS_iter;
       int sdr_id;
-      double wire_delay;
       double wire_delay_tx;
       double t_delay;
       bool enable_out;
 
       // Variables
-      af::array d_match_filt;
+      af::array d_tx_ref;
+      af::array d_mf_fft;
+      dim_t d_mf_len;
+      dim_t d_ols_nfft;
       af::Backend d_backend;
       size_t d_msg_queue_depth;
       double t_est;
       double p_est;
-      std::vector<double> d_sdr1_time_est;
-      std::vector<double> d_sdr2_time_est;
-      std::vector<double> d_sdr3_time_est;
-      std::vector<double> d_sdr1_phase_est;
-      std::vector<double> d_sdr2_phase_est;
-      std::vector<double> d_sdr3_phase_est;
       int d_rx_count;
-      double alpha1, alpha2, alpha3, alpha_hat;
+      double alpha_hat;
+
+      // TDMA schedule: transmitting platform of every slot, and of the slots
+      // this platform receives in (in order)
+      std::vector<int> d_slot_tx;
+      std::vector<int> d_rx_slot_tx;
+      int d_num_platforms;
+      std::vector<double> d_alpha;
+
+      // Dense N x N (tx, rx) estimate table, one entry per capture
+      struct link_est
+      {
+        std::vector<double> time;
+        std::vector<double> phase;
+        std::vector<double> cfar;
+        std::vector<double> snr;  // dB
+        std::vector<double> pslr; // dB
+        std::vector<double> var;  // CRLB of the time estimate (s^2)
+      };
+      std::vector<link_est> d_table;
+      size_t table_index(int tx, int rx) const { return static_cast<size_t>(tx - 1) * d_num_platforms + (rx - 1); }
+
+      // CA-CFAR detection (disabled when d_cfar_max_det == 0)
+      int d_cfar_guard;
+      int d_cfar_train;
+      double d_cfar_pfa;
+      int d_cfar_max_det;
+
+      // Number of sinc NLLS points around each peak
+      static constexpr int nlls_pts = 5;
 
 
       // Message Ports
@@ -68,7 +96,23 @@ namespace gr
       pmt::pmt_t d_tp_meta;
       pmt::pmt_t sdr_pmt;
 
-      af::array sinc(const af::array &x);
+      // Overlap-save segmentation for one (capture length, number of captures)
+      struct ols_plan
+      {
+        dim_t nseg;
+        dim_t pad_len;
+        af::array seg_idx;
+        af::array H;
+      };
+      std::map<std::pair<size_t, size_t>, ols_plan> d_ols_cache;
+
+      const ols_plan &get_ols_plan(size_t n, size_t num_captures);
+      af::array overlap_save(const af::array &x);
+      bool search_window(pmt::pmt_t meta, size_t n, dim_t &lag0, dim_t &n_win);
+      af::array windowed_correlation(const af::array &x, dim_t lag0, dim_t n_win);
+      af::array cfar_detect(const af::array &resp_abs);
+      af::array gather_peaks(const af::array &resp, const af::array &resp_abs, const af::array &lin_idx);
+      double refine_peak(const double *col, size_t max_idx, double &phase);
 
       void handle_tx_msg(pmt::pmt_t);
       void handle_rx_msg(pmt::pmt_t);
@@ -79,6 +123,8 @@ namespace gr
       ~time_pk_est_impl();
 
       void set_msg_queue_depth(size_t) override;
+      void set_tdma_schedule(const std::vector<int> &slot_tx) override;
+      void set_cfar(int guard_cells, int train_cells, double pfa, int max_detections) override;
       void set_backend(Device::Backend) override;
     };
 
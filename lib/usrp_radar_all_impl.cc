@@ -1282,22 +1282,30 @@ namespace gr
       }
 
       // Transmit Data Vector
-      std::vector<gr_complex> tx_data_vector(raw, raw + len);
-
-      // Fractional Delay via FFT Domian
-      af::array x = af::array(len, reinterpret_cast<const af::cfloat *>(raw), afHost);
-      // FFT
-      af::array X = af::fft(x);
-      X = ::plasma::fftshift(X, 0);
-      // Build frequency vector
-      af::array f = (-sdr1_rate / 2.0) + ((af::seq(0, len - 1)) * (sdr1_rate / len));
-      // Apply Delay and IFFT
-      af::array X_delay = X * af::exp(-1.0 * af::Im * 2.0 * M_PI * f * (tx_time_err));
-      X_delay = ::plasma::ifftshift(X_delay, 0);
-      af::array x_delay = af::ifft(X_delay);
-
-      // Copy back into tx_data_vector
-      x_delay.host(reinterpret_cast<af::cfloat *>(tx_data_vector.data()));
+      std::vector<gr_complex> tx_data_vector(len);
+
+      if (d_delay_method == delay_method::FIR)
+      {
+        // Polyphase FIR fractional delay by tx_time_err
+        d_fir[sdr_id - 1]->apply(raw, tx_data_vector.data(), len, tx_time_err * sdr1_rate);
+      }
+      else
+      {
+        // Fractional Delay via FFT Domian
+        af::array x = af::array(len, reinterpret_cast<const af::cfloat *>(raw), afHost);
+        // FFT
+        af::array X = af::fft(x);
+        X = ::plasma::fftshift(X, 0);
+        // Build frequency vector
+        af::array f = (-sdr1_rate / 2.0) + ((af::seq(0, len - 1)) * (sdr1_rate / len));
+        // Apply Delay and IFFT
+        af::array X_delay = X * af::exp(-1.0 * af::Im * 2.0 * M_PI * f * (tx_time_err));
+        X_delay = ::plasma::ifftshift(X_delay, 0);
+        af::array x_delay = af::ifft(X_delay);
+
+        // Copy back into tx_data_vector
+        x_delay.host(reinterpret_cast<af::cfloat *>(tx_data_vector.data()));
+      }
       if (tx_buffs.size() < 1)
         tx_buffs.resize(1);
       tx_buffs[0] = tx_data_vector;
@@ -1446,5 +1454,15 @@ namespace gr
       this->prf_key = prf_key;
     }
 
+    void usrp_radar_all_impl::set_delay_method(const std::string &method, int taps)
+    {
+      d_delay_method = delay_method_from_string(method);
+      if (d_delay_method != delay_method::FIR)
+        return;
+      for (auto &fir : d_fir)
+        if (!fir || fir->taps() != taps)
+          fir.reset(new fractional_delay(taps));
+    }
+
   } /* namespace harmonia */
 } /* namespace gr */
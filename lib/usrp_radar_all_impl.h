@@ -13,6 +13,7 @@
 #include <arrayfire.h>
 #include <plasma_dsp/pulsed_waveform.h>
 #include <plasma_dsp/fft.h>
+#include "fractional_delay.h"
 #include <nlohmann/json.hpp>
 #include <uhd/convert.hpp>
 #include <uhd/types/time_spec.hpp>
@@ -25,6 +26,8 @@
 #include <chrono>
 #include <sstream>
 #include <iomanip>
+#include <array>
+#include <memory>
 
 namespace gr
 {
@@ -137,6 +140,11 @@ namespace gr
       std::string sample_start_key;
       std::string prf_key;
 
+      // TX fractional delay method; one FIR engine per SDR so concurrent
+      // transmit threads do not share filter state
+      delay_method d_delay_method = delay_method::FFT;
+      std::array<std::unique_ptr<fractional_delay>, 3> d_fir;
+
     private:
       void config_usrp(uhd::usrp::multi_usrp::sptr &usrp_1,
                        uhd::usrp::multi_usrp::sptr &usrp_2,
@@ -167,6 +175,7 @@ namespace gr
                              const std::string &sdr2_freq_key,
                              const std::string &sample_start_key,
                              const std::string &prf_key);
+      void set_delay_method(const std::string &method, int taps);
       void setup_streamers(
           uhd::rx_streamer::sptr &rx1_stream,
           uhd::rx_streamer::sptr &rx2_stream,
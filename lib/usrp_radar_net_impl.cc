@@ -0,0 +1,432 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "usrp_radar_net_impl.h"
+#include <gnuradio/io_signature.h>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <set>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    usrp_radar_net::sptr usrp_radar_net::make(const std::string &config)
+    {
+      return gnuradio::make_block_sptr<usrp_radar_net_impl>(config);
+    }
+
+    /*
+     * The private constructor
+     */
+    usrp_radar_net_impl::usrp_radar_net_impl(const std::string &config)
+        : gr::block("usrp_radar_net",
+                    gr::io_signature::make(0, 0, 0),
+                    gr::io_signature::make(0, 0, 0)),
+          d_net(parse_radar_network(config)),
+          finished(false)
+    {
+      const size_t n = d_net.nodes.size();
+      d_nodes.resize(n);
+      d_range.assign(n * n, 0.0);
+      d_armed.assign(d_net.phases.size(), false);
+      d_executed.assign(d_net.phases.size(), false);
+      for (size_t p = 0; p < d_net.phases.size(); p++)
+        d_armed[p] = d_net.phases[p].enable == "start";
+
+      for (size_t k = 0; k < n; k++)
+      {
+        d_nodes[k].cfg = d_net.nodes[k];
+        config_usrp(d_nodes[k], k + 1);
+      }
+
+      // One output port per node for every port a phase publishes on
+      std::set<std::string> ports;
+      for (const auto &phase : d_net.phases)
+        ports.insert(phase.port);
+
+      for (size_t k = 0; k < n; k++)
+      {
+        const int id = k + 1;
+        for (const auto &port : ports)
+          message_port_register_out(node_port(port, id));
+
+        pmt::pmt_t in = node_port("in", id);
+        message_port_register_in(in);
+        set_msg_handler(in, [this, id](pmt::pmt_t msg)
+                        { this->handle_message(msg, id); });
+      }
+    }
+
+    /*
+     * Our virtual destructor.
+     */
+    usrp_radar_net_impl::~usrp_radar_net_impl() {}
+
+    bool usrp_radar_net_impl::start()
+    {
+      finished = false;
+      for (auto &node : d_nodes)
+        setup_streamers(node);
+      main_thread = gr::thread::thread(&usrp_radar_net_impl::run_ready_phases, this);
+
+      return block::start();
+    }
+
+    bool usrp_radar_net_impl::stop()
+    {
+      finished = true;
+      if (main_thread.joinable())
+        main_thread.join();
+      return block::stop();
+    }
+
+    // Node 1 keeps the bare port name ("in", "cd_out"), node k appends k
+    pmt::pmt_t usrp_radar_net_impl::node_port(const std::string &prefix, int node)
+    {
+      return pmt::intern(node == 1 ? prefix : prefix + std::to_string(node));
+    }
+
+    void usrp_radar_net_impl::handle_message(const pmt::pmt_t &msg, int node)
+    {
+      if (!pmt::is_pair(msg))
+        return;
+
+      pmt::pmt_t meta = pmt::car(msg);
+      if (!pmt::is_dict(meta))
+        return;
+
+      {
+        gr::thread::scoped_lock lock(d_mutex);
+        const int n = static_cast<int>(d_nodes.size());
+
+        // Update TX data with the new waveform
+        if (pmt::is_c32vector(pmt::cdr(msg)))
+        {
+          node_context &ctx = d_nodes[node - 1];
+          pmt::pmt_t label = pmt::dict_ref(meta, PMT_HARMONIA_LABEL, pmt::PMT_NIL);
+          if (pmt::is_symbol(label))
+            ctx.waveforms[pmt::symbol_to_string(label)] = msg;
+          ctx.latest = msg;
+        }
+
+        // Clock drift, clock bias and range estimates for any node
+        for (int k = 0; k < n; k++)
+        {
+          pmt::pmt_t cd = pmt::dict_ref(meta, harmonia_sdr_key("sdr", k + 1), pmt::PMT_NIL);
+          if (pmt::is_number(cd))
+          {
+            d_nodes[k].drift = pmt::to_double(cd);
+            d_nodes[k].drift_ready = true;
+          }
+          pmt::pmt_t cb = pmt::dict_ref(meta, harmonia_sdr_key("cb_sdr", k + 1), pmt::PMT_NIL);
+          if (pmt::is_number(cb))
+          {
+            d_nodes[k].bias = pmt::to_double(cb);
+            d_nodes[k].bias_ready = true;
+          }
+          for (int r = k + 1; r < n; r++)
+          {
+            pmt::pmt_t key = pmt::intern("R_sdr" + std::to_string(k + 1) + std::to_string(r + 1));
+            pmt::pmt_t R = pmt::dict_ref(meta, key, pmt::PMT_NIL);
+            if (pmt::is_number(R))
+              d_range[k * n + r] = d_range[r * n + k] = pmt::to_double(R);
+          }
+        }
+
+        // Arm the phases this waveform enables (e.g. clock_drift_enable)
+        for (size_t p = 0; p < d_net.phases.size(); p++)
+        {
+          const std::string &flag = d_net.phases[p].enable;
+          if (flag != "start" && pmt::to_bool(pmt::dict_ref(meta, pmt::intern(flag), pmt::PMT_F)))
+            d_armed[p] = true;
+        }
+      }
+
+      run_ready_phases();
+    }
+
+    bool usrp_radar_net_impl::phase_ready(size_t p) const
+    {
+      const radar_phase &phase = d_net.phases[p];
+      if (!d_armed[p] || d_executed[p])
+        return false;
+
+      if (!phase.after.empty())
+      {
+        for (size_t q = 0; q < d_net.phases.size(); q++)
+          if (d_net.phases[q].name == phase.after && !d_executed[q])
+            return false;
+      }
+
+      for (const auto &need : phase.needs)
+      {
+        if (need == "drift" && !std::all_of(d_nodes.begin(), d_nodes.end(),
+                                            [](const node_context &ctx)
+                                            { return ctx.drift_ready; }))
+          return false;
+        if (need == "bias" && !std::all_of(d_nodes.begin(), d_nodes.end(),
+                                           [](const node_context &ctx)
+                                           { return ctx.bias_ready; }))
+          return false;
+        if (need == "waveform")
+        {
+          for (const auto &slot : phase.slots)
+            for (int k : slot.tx)
+              if (phase.waveform.empty() ? pmt::is_null(d_nodes[k].latest)
+                                         : !d_nodes[k].waveforms.count(phase.waveform))
+                return false;
+        }
+      }
+      return true;
+    }
+
+    void usrp_radar_net_impl::run_ready_phases()
+    {
+      // One phase at a time; finishing a phase may release the next one
+      gr::thread::scoped_lock run_lock(d_run_mutex);
+      while (!finished)
+      {
+        phase_plan plan;
+        {
+          gr::thread::scoped_lock lock(d_mutex);
+          size_t p = 0;
+          while (p < d_net.phases.size() && !phase_ready(p))
+            p++;
+          if (p == d_net.phases.size())
+            return;
+          d_executed[p] = true;
+
+          const radar_phase &phase = d_net.phases[p];
+          std::vector<double> drift, bias;
+          for (const auto &ctx : d_nodes)
+          {
+            drift.push_back(ctx.drift);
+            bias.push_back(ctx.bias);
+          }
+
+          plan.name = phase.name;
+          plan.port = phase.port;
+          plan.capture = phase.capture;
+          plan.timeline = schedule_phase(d_net, phase, drift, bias, d_range);
+          for (const auto &ctx : d_nodes)
+          {
+            auto it = ctx.waveforms.find(phase.waveform);
+            plan.tx_data.push_back(phase.waveform.empty() ? ctx.latest
+                                   : it != ctx.waveforms.end() ? it->second
+                                                               : pmt::PMT_NIL);
+          }
+        }
+
+        GR_LOG_INFO(d_logger, "Launching phase " + plan.name + ".");
+        run_phase(plan);
+        GR_LOG_INFO(d_logger, "Phase " + plan.name + " TX/RX sequence completed.");
+      }
+    }
+
+    void usrp_radar_net_impl::run_phase(const phase_plan &plan)
+    {
+      // A TX and an RX thread per node, each walking its own burst times
+      std::vector<gr::thread::thread> threads;
+      for (size_t k = 0; k < d_nodes.size(); k++)
+      {
+        const radar_timeline &tl = plan.timeline[k];
+        if (!tl.tx_times.empty())
+          threads.emplace_back(&usrp_radar_net_impl::transmit_all, this, k + 1,
+                               tl.tx_times, plan.tx_data[k]);
+        if (!tl.rx_times.empty())
+          threads.emplace_back(&usrp_radar_net_impl::receive_all, this, k + 1,
+                               tl.rx_times, plan.capture, node_port(plan.port, k + 1));
+      }
+      for (auto &t : threads)
+        t.join();
+    }
+
+    void usrp_radar_net_impl::config_usrp(node_context &node, int id)
+    {
+      const radar_node_config &cfg = node.cfg;
+      uhd::usrp::multi_usrp::sptr usrp = uhd::usrp::multi_usrp::make(cfg.args);
+      if (not cfg.tx_subdev.empty())
+        usrp->set_tx_subdev_spec(cfg.tx_subdev);
+      if (not cfg.rx_subdev.empty())
+        usrp->set_rx_subdev_spec(cfg.rx_subdev);
+      usrp->set_tx_rate(cfg.rate);
+      usrp->set_rx_rate(cfg.rate);
+      usrp->set_tx_freq(cfg.freq);
+      usrp->set_rx_freq(cfg.freq);
+      usrp->set_tx_gain(cfg.tx_gain);
+      usrp->set_rx_gain(cfg.rx_gain);
+      if (not cfg.tx_antenna.empty())
+        usrp->set_tx_antenna(cfg.tx_antenna, 0);
+      if (not cfg.rx_antenna.empty())
+        usrp->set_rx_antenna(cfg.rx_antenna, 0);
+
+      // Sets USRP Clock/Time Source
+      if (not cfg.clock_source.empty())
+        usrp->set_clock_source(cfg.clock_source);
+      if (not cfg.time_source.empty())
+        usrp->set_time_source(cfg.time_source);
+
+      // Sets USRP Time to 0.0 ***ONLY FOR COARSE SYNCHRONIZATION
+      usrp->set_time_now(uhd::time_spec_t(0.0));
+
+      if (d_net.verbose)
+      {
+        std::cout << boost::format("Using Device %d: %s") % id % usrp->get_pp_string()
+                  << std::endl;
+        std::cout << boost::format("Actual TX/RX Rate: %f / %f Msps") %
+                         (usrp->get_tx_rate() / 1e6) % (usrp->get_rx_rate() / 1e6)
+                  << std::endl;
+        std::cout << boost::format("Actual TX/RX Freq: %f / %f MHz") %
+                         (usrp->get_tx_freq() / 1e6) % (usrp->get_rx_freq() / 1e6)
+                  << std::endl;
+        std::cout << boost::format("Actual TX/RX Gain: %f / %f dB") %
+                         usrp->get_tx_gain() % usrp->get_rx_gain()
+                  << std::endl;
+      }
+      node.usrp = usrp;
+    }
+
+    void usrp_radar_net_impl::setup_streamers(node_context &node)
+    {
+      const std::vector<size_t> channel_nums(1, 0);
+
+      uhd::stream_args_t rx_args(node.cfg.cpu_format, node.cfg.otw_format);
+      rx_args.channels = channel_nums;
+      node.rx_stream = node.usrp->get_rx_stream(rx_args);
+
+      uhd::stream_args_t tx_args(node.cfg.cpu_format, node.cfg.otw_format);
+      tx_args.channels = channel_nums;
+      node.tx_stream = node.usrp->get_tx_stream(tx_args);
+    }
+
+    void usrp_radar_net_impl::transmit_all(int node, const std::vector<double> &times,
+                                           pmt::pmt_t data)
+    {
+      // Validate
+      if (!pmt::is_pair(data) || !pmt::is_c32vector(pmt::cdr(data)))
+      {
+        GR_LOG_ERROR(d_logger, "No TX waveform for SDR " + std::to_string(node));
+        return;
+      }
+
+      size_t len = 0;
+      const gr_complex *raw = pmt::c32vector_elements(pmt::cdr(data), len);
+      if (!raw || len == 0)
+      {
+        GR_LOG_ERROR(d_logger, "Invalid TX data for SDR " + std::to_string(node));
+        return;
+      }
+
+      // TX time error due to the time resolution, taken out by the
+      // fractional delay
+      const double resolution = 1.0 / d_nodes[node - 1].cfg.rate;
+      for (double t : times)
+        this->transmit_bursts(node, t, std::remainder(t, resolution), raw, len);
+    }
+
+    void usrp_radar_net_impl::receive_all(int node, const std::vector<double> &times,
+                                          double capture, pmt::pmt_t port)
+    {
+      const double resolution = 1.0 / d_nodes[node - 1].cfg.rate;
+      for (double t : times)
+        this->receive(node, t, std::remainder(t, resolution), capture, port);
+    }
+
+    void usrp_radar_net_impl::transmit_bursts(int node, double start_time, double tx_time_err,
+                                              const gr_complex *raw, size_t len)
+    {
+      node_context &ctx = d_nodes[node - 1];
+      const double rate = ctx.cfg.rate;
+      uhd::tx_metadata_t md;
+
+      // Transmit Data Vector
+      std::vector<gr_complex> tx_data_vector(len);
+
+      if (d_delay_method == delay_method::FIR)
+      {
+        // Polyphase FIR fractional delay by tx_time_err
+        ctx.fir->apply(raw, tx_data_vector.data(), len, tx_time_err * rate);
+      }
+      else
+      {
+        // Fractional Delay via FFT Domian
+        af::array x = af::array(len, reinterpret_cast<const af::cfloat *>(raw), afHost);
+        af::array X = af::fft(x);
+        X = ::plasma::fftshift(X, 0);
+        af::array f = (-rate / 2.0) + ((af::seq(0, len - 1)) * (rate / len));
+        af::array X_delay = X * af::exp(-1.0 * af::Im * 2.0 * M_PI * f * (tx_time_err));
+        X_delay = ::plasma::ifftshift(X_delay, 0);
+        af::array x_delay = af::ifft(X_delay);
+        x_delay.host(reinterpret_cast<af::cfloat *>(tx_data_vector.data()));
+      }
+
+      // Populate metadata
+      md.start_of_burst = true;
+      md.end_of_burst = true;
+      md.has_time_spec = true;
+
+      long long ticks_req = (long long)std::floor(start_time * rate);
+      md.time_spec = uhd::time_spec_t::from_ticks(ticks_req, rate);
+
+      double timeout = 0.0;
+      ctx.tx_stream->send(tx_data_vector.data(), tx_data_vector.size(), md, timeout);
+    }
+
+    void usrp_radar_net_impl::receive(int node, double start_time, double rx_time_error,
+                                      double capture, pmt::pmt_t port)
+    {
+      node_context &ctx = d_nodes[node - 1];
+      const double rate = ctx.cfg.rate;
+      uhd::rx_metadata_t md;
+
+      // Total samples to receive based on capture time
+      size_t total_samps_to_rx = capture * rate;
+      size_t samps_received = 0;
+
+      // Set up UHD receive mode
+      uhd::stream_cmd_t cmd(uhd::stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_DONE);
+      cmd.num_samps = total_samps_to_rx;
+      cmd.stream_now = ctx.usrp->get_time_now().get_real_secs() >= start_time;
+
+      long long ticks_req = (long long)std::floor(start_time * rate);
+      cmd.time_spec = uhd::time_spec_t::from_ticks(ticks_req, rate);
+
+      ctx.rx_stream->issue_stream_cmd(cmd);
+
+      // Allocate buffer
+      pmt::pmt_t rx_data_pmt = pmt::make_c32vector(total_samps_to_rx, 0);
+      gr_complex *rx_data_ptr = pmt::c32vector_writable_elements(rx_data_pmt, total_samps_to_rx);
+
+      double timeout = 0.0;
+      while (samps_received < total_samps_to_rx && !finished)
+      {
+        size_t samps_to_recv = total_samps_to_rx - samps_received;
+        samps_received += ctx.rx_stream->recv(rx_data_ptr + samps_received, samps_to_recv, md, timeout);
+      }
+
+      // Assign RX Time metadata
+      pmt::pmt_t meta = pmt::dict_add(pmt::make_dict(), PMT_HARMONIA_RX_ERROR,
+                                      pmt::from_double(rx_time_error));
+      message_port_pub(port, pmt::cons(meta, rx_data_pmt));
+    }
+
+    void usrp_radar_net_impl::set_delay_method(const std::string &method, int taps)
+    {
+      d_delay_method = delay_method_from_string(method);
+      if (d_delay_method != delay_method::FIR)
+        return;
+      for (auto &node : d_nodes)
+        if (!node.fir || node.fir->taps() != taps)
+          node.fir.reset(new fractional_delay(taps));
+    }
+
+  } /* namespace harmonia */
+} /* namespace gr */
@@ -0,0 +1,109 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_HARMONIA_USRP_RADAR_NET_IMPL_H
+#define INCLUDED_HARMONIA_USRP_RADAR_NET_IMPL_H
+
+#include <gnuradio/harmonia/pmt_constants.h>
+#include <gnuradio/harmonia/usrp_radar_net.h>
+#include <arrayfire.h>
+#include <plasma_dsp/fft.h>
+#include "fractional_delay.h"
+#include "radar_network.h"
+#include <uhd/types/time_spec.hpp>
+#include <uhd/usrp/multi_usrp.hpp>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    class usrp_radar_net_impl : public usrp_radar_net
+    {
+    private:
+      // Everything the scheduler needs about one radio
+      struct node_context
+      {
+        radar_node_config cfg;
+        uhd::usrp::multi_usrp::sptr usrp;
+        uhd::tx_streamer::sptr tx_stream;
+        uhd::rx_streamer::sptr rx_stream;
+
+        // Latest waveform PDU per label, and the latest of any label
+        std::map<std::string, pmt::pmt_t> waveforms;
+        pmt::pmt_t latest = pmt::PMT_NIL;
+
+        double drift = 1.0;
+        double bias = 0.0;
+        bool drift_ready = false;
+        bool bias_ready = false;
+
+        // TX fractional delay engine; one per node so concurrent transmit
+        // threads do not share filter state
+        std::unique_ptr<fractional_delay> fir;
+      };
+
+      // A phase resolved against the current estimates, ready to run
+      struct phase_plan
+      {
+        std::string name;
+        std::string port;
+        double capture;
+        std::vector<radar_timeline> timeline;
+        std::vector<pmt::pmt_t> tx_data; // per node, PMT_NIL if it does not transmit
+      };
+
+      radar_network d_net;
+      std::vector<node_context> d_nodes;
+      std::vector<double> d_range; // node-major N x N (m)
+      std::vector<bool> d_armed;
+      std::vector<bool> d_executed;
+
+      // d_mutex guards the state above; d_run_mutex keeps phases from
+      // sharing the streamers
+      gr::thread::mutex d_mutex;
+      gr::thread::mutex d_run_mutex;
+      gr::thread::thread main_thread;
+      std::atomic<bool> finished;
+
+      delay_method d_delay_method = delay_method::FFT;
+
+      static pmt::pmt_t node_port(const std::string &prefix, int node);
+
+      void config_usrp(node_context &node, int id);
+      void setup_streamers(node_context &node);
+      void handle_message(const pmt::pmt_t &msg, int node);
+      bool phase_ready(size_t p) const;
+      void run_ready_phases();
+      void run_phase(const phase_plan &plan);
+      void transmit_all(int node, const std::vector<double> &times, pmt::pmt_t data);
+      void receive_all(int node, const std::vector<double> &times, double capture,
+                       pmt::pmt_t port);
+      void transmit_bursts(int node, double start_time, double tx_time_err,
+                           const gr_complex *raw, size_t len);
+      void receive(int node, double start_time, double rx_time_error, double capture,
+                   pmt::pmt_t port);
+
+    public:
+      usrp_radar_net_impl(const std::string &config);
+      ~usrp_radar_net_impl();
+
+      bool start() override;
+      bool stop() override;
+
+      void set_delay_method(const std::string &method, int taps) override;
+      int num_nodes() const override { return static_cast<int>(d_nodes.size()); }
+    };
+
+  } // namespace harmonia
+} // namespace gr
+
+#endif /* INCLUDED_HARMONIA_USRP_RADAR_NET_IMPL_H */
@@ -165,6 +165,13 @@ namespace gr
       rx_stream = usrp->get_rx_stream(rx_args);
     }
 
+    void usrp_radar_tdma_impl::set_delay_method(const std::string &method, int taps)
+    {
+      d_delay_method = delay_method_from_string(method);
+      if (d_delay_method == delay_method::FIR && (!d_fir || d_fir->taps() != taps))
+        d_fir.reset(new fractional_delay(taps));
+    }
+
     void usrp_radar_tdma_impl::handle_message(const pmt::pmt_t &msg)
     {
       if (!pmt::is_pair(msg))
@@ -499,22 +506,30 @@ namespace gr
         return;
       }
 
-      std::vector<gr_complex> tx_data_vector(raw, raw + len);
-
-      // Convert into AF
-      af::array x = af::array(len, reinterpret_cast<const af::cfloat *>(raw), afHost);
-      // FFT
-      af::array X = af::fft(x);
-      X = ::plasma::fftshift(X, 0);
-      // Build frequency vector
-      af::array f = (-sdr_rate / 2.0) + ((af::seq(0, len - 1)) * (sdr_rate / len));
-      // Apply Delay and IFFT
-      af::array X_delay = X * af::exp(-1.0 * af::Im * 2.0 * M_PI * f * (tx_time_err));
-      X_delay = ::plasma::ifftshift(X_delay, 0);
-      af::array x_delay = af::ifft(X_delay);
-
-      // Copy back into tx_data_vector
-      x_delay.host(reinterpret_cast<af::cfloat *>(tx_data_vector.data()));
+      std::vector<gr_complex> tx_data_vector(len);
+
+      if (d_delay_method == delay_method::FIR)
+      {
+        // Polyphase FIR fractional delay by tx_time_err
+        d_fir->apply(raw, tx_data_vector.data(), len, tx_time_err * sdr_rate);
+      }
+      else
+      {
+        // Convert into AF
+        af::array x = af::array(len, reinterpret_cast<const af::cfloat *>(raw), afHost);
+        // FFT
+        af::array X = af::fft(x);
+        X = ::plasma::fftshift(X, 0);
+        // Build frequency vector
+        af::array f = (-sdr_rate / 2.0) + ((af::seq(0, len - 1)) * (sdr_rate / len));
+        // Apply Delay and IFFT
+        af::array X_delay = X * af::exp(-1.0 * af::Im * 2.0 * M_PI * f * (tx_time_err));
+        X_delay = ::plasma::ifftshift(X_delay, 0);
+        af::array x_delay = af::ifft(X_delay);
+
+        // Copy back into tx_data_vector
+        x_delay.host(reinterpret_cast<af::cfloat *>(tx_data_vector.data()));
+      }
 
       if (tx_buffs.size() < 1)
         tx_buffs.resize(1);
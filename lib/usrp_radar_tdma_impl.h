@@ -13,6 +13,7 @@
 #include <arrayfire.h>
 #include <plasma_dsp/pulsed_waveform.h>
 #include <plasma_dsp/fft.h>
+#include "fractional_delay.h"
 #include <nlohmann/json.hpp>
 #include <uhd/convert.hpp>
 #include <uhd/types/time_spec.hpp>
@@ -25,6 +26,7 @@
 #include <chrono>
 #include <sstream>
 #include <iomanip>
+#include <memory>
 
 namespace gr
 {
@@ -82,6 +84,10 @@ namespace gr
       pmt::pmt_t tx_data;
       pmt::pmt_t meta;
 
+      // TX fractional delay method
+      delay_method d_delay_method = delay_method::FFT;
+      std::unique_ptr<fractional_delay> d_fir;
+
       void config_usrp(uhd::usrp::multi_usrp::sptr &usrp,
                        const std::string &args,
                        const double sdr_rate,
@@ -134,6 +140,7 @@ namespace gr
       bool start() override;
       bool stop() override;
       void handle_message(const pmt::pmt_t &msg);
+      void set_delay_method(const std::string &method, int taps) override;
     };
 
   } // namespace harmonia
@@ -0,0 +1,218 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "waveform_library.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    namespace
+    {
+
+      size_t pulse_samples(const waveform_params &p)
+      {
+        const size_t n = static_cast<size_t>(std::round(p.samp_rate * p.pulse_width));
+        if (n == 0)
+          throw std::invalid_argument("waveform pulse has no samples");
+        return n;
+      }
+
+      size_t chip_samples(const waveform_params &p)
+      {
+        if (p.code_length < 1)
+          throw std::invalid_argument("waveform code_length must be positive");
+        const size_t n = static_cast<size_t>(std::round(p.samp_rate * p.pulse_width / p.code_length));
+        return n > 0 ? n : 1;
+      }
+
+      // Repeat each chip phase over its samples
+      std::vector<gr_complex> chips_to_samples(const std::vector<double> &phase, size_t spc)
+      {
+        std::vector<gr_complex> x(phase.size() * spc);
+        for (size_t k = 0; k < phase.size(); k++)
+        {
+          const gr_complex v = std::polar(1.0f, static_cast<float>(phase[k]));
+          std::fill(x.begin() + k * spc, x.begin() + (k + 1) * spc, v);
+        }
+        return x;
+      }
+
+      // Upchirp over [-B/2, B/2]
+      std::vector<gr_complex> lfm(const waveform_params &p)
+      {
+        const size_t n = pulse_samples(p);
+        const double T = p.pulse_width;
+        std::vector<gr_complex> x(n);
+        for (size_t k = 0; k < n; k++)
+        {
+          const double t = k / p.samp_rate;
+          const double phase = 2.0 * M_PI * (-p.bandwidth / 2.0 * t + p.bandwidth / (2.0 * T) * t * t);
+          x[k] = std::polar(1.0f, static_cast<float>(std::remainder(phase, 2.0 * M_PI)));
+        }
+        return x;
+      }
+
+      // Tangent FM: f(t) = B/2 * tan(shape * u) / tan(shape), u = 2t/T - 1,
+      // which dwells longer at the band edges and so tapers the spectrum
+      // without amplitude weighting
+      std::vector<gr_complex> nlfm(const waveform_params &p)
+      {
+        if (!(p.shape > 0.0 && p.shape < M_PI / 2.0))
+          throw std::invalid_argument("nlfm shape must be in (0, pi/2)");
+        const size_t n = pulse_samples(p);
+        const double T = p.pulse_width;
+        const double scale = 2.0 * M_PI * (p.bandwidth / (2.0 * std::tan(p.shape))) * (T / (2.0 * p.shape));
+        std::vector<gr_complex> x(n);
+        for (size_t k = 0; k < n; k++)
+        {
+          const double u = 2.0 * (k / p.samp_rate) / T - 1.0;
+          const double phase = -scale * std::log(std::cos(p.shape * u));
+          x[k] = std::polar(1.0f, static_cast<float>(std::remainder(phase, 2.0 * M_PI)));
+        }
+        return x;
+      }
+
+      // x[m] = exp(-j pi u m (m + (N mod 2)) / N)
+      std::vector<gr_complex> zadoff_chu(const waveform_params &p)
+      {
+        const long N = p.code_length;
+        const long u = p.code_root;
+        long a = N, b = u;
+        while (b != 0)
+        {
+          const long r = a % b;
+          a = b;
+          b = r;
+        }
+        if (N < 1 || u < 1 || u >= N || a != 1)
+          throw std::invalid_argument("zadoff_chu root must be in [1, N) and coprime with N");
+
+        std::vector<double> phase(N);
+        for (long m = 0; m < N; m++)
+        {
+          // Reduce m (m + N mod 2) mod 2N exactly before scaling
+          const long q = (m * (m + (N % 2))) % (2 * N);
+          phase[m] = -M_PI * static_cast<double>((u * q) % (2 * N)) / N;
+        }
+        return chips_to_samples(phase, chip_samples(p));
+      }
+
+      std::vector<gr_complex> barker(const waveform_params &p)
+      {
+        static const std::map<int, std::vector<int>> codes = {
+            {2, {1, -1}},
+            {3, {1, 1, -1}},
+            {4, {1, 1, -1, 1}},
+            {5, {1, 1, 1, -1, 1}},
+            {7, {1, 1, 1, -1, -1, 1, -1}},
+            {11, {1, 1, 1, -1, -1, -1, 1, -1, -1, 1, -1}},
+            {13, {1, 1, 1, 1, 1, -1, -1, 1, 1, -1, 1, -1, 1}}};
+        auto it = codes.find(p.code_length);
+        if (it == codes.end())
+          throw std::invalid_argument("barker code_length must be 2, 3, 4, 5, 7, 11 or 13");
+
+        std::vector<double> phase;
+        for (int c : it->second)
+          phase.push_back(c > 0 ? 0.0 : M_PI);
+        return chips_to_samples(phase, chip_samples(p));
+      }
+
+      // Welch Costas array of order N = p - 1 (p prime): chip k hops to
+      // g^k mod p, g a primitive root, with tone spacing 1 / chip duration.
+      // Phase is continuous across hops.
+      std::vector<gr_complex> costas(const waveform_params &p)
+      {
+        const int N = p.code_length;
+        const int prime = N + 1;
+        bool is_prime = prime >= 3;
+        for (int d = 2; is_prime && d * d <= prime; d++)
+          is_prime = (prime % d) != 0;
+        if (!is_prime)
+          throw std::invalid_argument("costas code_length + 1 must be an odd prime");
+
+        int g = 2;
+        for (; g < prime; g++)
+        {
+          int v = 1, order = 0;
+          do
+          {
+            v = (v * g) % prime;
+            order++;
+          } while (v != 1);
+          if (order == N)
+            break;
+        }
+
+        const size_t spc = chip_samples(p);
+        const double df = p.samp_rate / spc;
+        std::vector<gr_complex> x(N * spc);
+        double phase = 0.0;
+        int a = 1;
+        for (int k = 0; k < N; k++)
+        {
+          a = (a * g) % prime;
+          const double f = (a - (N + 1) / 2.0) * df;
+          const double inc = 2.0 * M_PI * f / p.samp_rate;
+          for (size_t i = 0; i < spc; i++)
+          {
+            x[k * spc + i] = std::polar(1.0f, static_cast<float>(phase));
+            phase = std::remainder(phase + inc, 2.0 * M_PI);
+          }
+        }
+        return x;
+      }
+
+    } // namespace
+
+    waveform_library &waveform_library::instance()
+    {
+      static waveform_library library;
+      return library;
+    }
+
+    waveform_library::waveform_library()
+    {
+      d_generators["lfm"] = lfm;
+      d_generators["nlfm"] = nlfm;
+      d_generators["zadoff_chu"] = zadoff_chu;
+      d_generators["barker"] = barker;
+      d_generators["costas"] = costas;
+    }
+
+    void waveform_library::add(const std::string &name, waveform_generator generator)
+    {
+      d_generators[name] = generator;
+    }
+
+    bool waveform_library::has(const std::string &name) const
+    {
+      return d_generators.count(name) > 0;
+    }
+
+    std::vector<std::string> waveform_library::names() const
+    {
+      std::vector<std::string> out;
+      for (const auto &g : d_generators)
+        out.push_back(g.first);
+      return out;
+    }
+
+    std::vector<gr_complex> waveform_library::generate(const std::string &name,
+                                                       const waveform_params &params) const
+    {
+      auto it = d_generators.find(name);
+      if (it == d_generators.end())
+        throw std::invalid_argument("unknown waveform: " + name);
+      return it->second(params);
+    }
+
+  } // namespace harmonia
+} // namespace gr
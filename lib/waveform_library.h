@@ -0,0 +1,66 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_HARMONIA_WAVEFORM_LIBRARY_H
+#define INCLUDED_HARMONIA_WAVEFORM_LIBRARY_H
+
+#include <gnuradio/gr_complex.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    /*
+     * Pulse description shared by all generators. Coded waveforms split the
+     * pulse into code_length chips of pulse_width / code_length each.
+     */
+    struct waveform_params
+    {
+      double samp_rate = 1.0;
+      double pulse_width = 0.0;
+      double bandwidth = 0.0;  // swept bandwidth (LFM, NLFM)
+      int code_length = 13;    // chips (Zadoff-Chu, Barker, Costas)
+      int code_root = 1;       // Zadoff-Chu root, coprime with code_length
+      double shape = 1.2;      // NLFM tangent-FM shape, 0 < shape < pi/2
+    };
+
+    typedef std::function<std::vector<gr_complex>(const waveform_params &)> waveform_generator;
+
+    /*
+     * Registry of named baseband pulse generators. The built-ins are "lfm",
+     * "nlfm" (tangent FM, lower range sidelobes than LFM for the same
+     * bandwidth), "zadoff_chu", "barker" and "costas" (Welch construction);
+     * further families can be added at run time with add().
+     */
+    class waveform_library
+    {
+    public:
+      static waveform_library &instance();
+
+      void add(const std::string &name, waveform_generator generator);
+      bool has(const std::string &name) const;
+      std::vector<std::string> names() const;
+
+      // Unit-amplitude pulse samples; throws std::invalid_argument for an
+      // unknown name or parameters the family does not support
+      std::vector<gr_complex> generate(const std::string &name, const waveform_params &params) const;
+
+    private:
+      waveform_library();
+
+      std::map<std::string, waveform_generator> d_generators;
+    };
+
+  } // namespace harmonia
+} // namespace gr
+
+#endif /* INCLUDED_HARMONIA_WAVEFORM_LIBRARY_H */
@@ -0,0 +1,103 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "waveform_src_impl.h"
+#include "matched_filter.h"
+#include <gnuradio/io_signature.h>
+#include <algorithm>
+#include <cmath>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    waveform_src::sptr waveform_src::make(const std::string &waveform, double samp_rate,
+                                          double pulse_width, double bandwidth, int code_length,
+                                          int code_root, double prf, int zeropad)
+    {
+      return gnuradio::make_block_sptr<waveform_src_impl>(
+          waveform, samp_rate, pulse_width, bandwidth, code_length, code_root, prf, zeropad);
+    }
+
+    /*
+     * The private constructor
+     */
+    waveform_src_impl::waveform_src_impl(const std::string &waveform, double samp_rate,
+                                         double pulse_width, double bandwidth, int code_length,
+                                         int code_root, double prf, int zeropad)
+        : gr::block("waveform_src",
+                    gr::io_signature::make(0, 0, 0),
+                    gr::io_signature::make(0, 0, 0)),
+          d_waveform(waveform),
+          prf(prf),
+          zeropad(zeropad)
+    {
+      d_params.samp_rate = samp_rate;
+      d_params.pulse_width = pulse_width;
+      d_params.bandwidth = bandwidth;
+      d_params.code_length = code_length;
+      d_params.code_root = code_root;
+
+      std::vector<gr_complex> pulse = waveform_library::instance().generate(d_waveform, d_params);
+
+      // Size the pulse train once: pulse, zeros to the PRI, and zeropad / 2
+      // on either side
+      size_t n = pulse.size();
+      if (prf > 0)
+        n = std::max(n, static_cast<size_t>(std::round(samp_rate / prf)));
+      const size_t n_pad = zeropad > 0 ? zeropad / 2 : 0;
+
+      d_data = pmt::make_c32vector(n + 2 * n_pad, gr_complex(0.0f, 0.0f));
+      size_t len = 0;
+      gr_complex *out = pmt::c32vector_writable_elements(d_data, len);
+      std::copy(pulse.begin(), pulse.end(), out + n_pad);
+
+      d_mf_meta = attach_mf_spectrum(pmt::make_dict(), out, len);
+      meta = pmt::make_dict();
+
+      message_port_register_in(PMT_HARMONIA_IN);
+      message_port_register_out(PMT_HARMONIA_OUT);
+      set_msg_handler(PMT_HARMONIA_IN, [this](pmt::pmt_t msg)
+                      { handle_msg(msg); });
+    }
+
+    /*
+     * Our virtual destructor.
+     */
+    waveform_src_impl::~waveform_src_impl() {}
+
+    bool waveform_src_impl::start()
+    {
+      // Send a PDU containing the waveform and its metadata
+      message_port_pub(PMT_HARMONIA_OUT, pmt::cons(pmt::dict_update(meta, d_mf_meta), d_data));
+
+      return block::start();
+    }
+
+    void waveform_src_impl::handle_msg(pmt::pmt_t msg)
+    {
+      // The waveform is fixed; any message republishes it
+      message_port_pub(PMT_HARMONIA_OUT, pmt::cons(pmt::dict_update(meta, d_mf_meta), d_data));
+    }
+
+    void waveform_src_impl::init_meta_dict(const std::string &bandwidth_key,
+                                           const std::string &duration_key,
+                                           const std::string &sample_rate_key,
+                                           const std::string &label_key,
+                                           const std::string &prf_key)
+    {
+      meta = pmt::make_dict();
+      meta = pmt::dict_add(meta, pmt::intern(bandwidth_key), pmt::from_double(d_params.bandwidth));
+      meta = pmt::dict_add(meta, pmt::intern(duration_key), pmt::from_double(d_params.pulse_width));
+      meta = pmt::dict_add(meta, pmt::intern(sample_rate_key), pmt::from_double(d_params.samp_rate));
+      meta = pmt::dict_add(meta, pmt::intern(label_key), pmt::intern(d_waveform));
+      meta = pmt::dict_add(meta, pmt::intern(prf_key), pmt::from_double(prf));
+    }
+
+  } /* namespace harmonia */
+} /* namespace gr */
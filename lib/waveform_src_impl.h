@@ -0,0 +1,56 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_HARMONIA_WAVEFORM_SRC_IMPL_H
+#define INCLUDED_HARMONIA_WAVEFORM_SRC_IMPL_H
+
+#include <gnuradio/harmonia/waveform_src.h>
+#include <gnuradio/harmonia/pmt_constants.h>
+#include "waveform_library.h"
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    class waveform_src_impl : public waveform_src
+    {
+    private:
+      // Waveform parameters
+      std::string d_waveform;
+      waveform_params d_params;
+      double prf;
+      int zeropad;
+
+      // IQ data and its matched filter metadata
+      pmt::pmt_t d_data;
+      pmt::pmt_t d_mf_meta;
+
+      // Metadata
+      pmt::pmt_t meta;
+
+      void handle_msg(pmt::pmt_t msg);
+
+    public:
+      waveform_src_impl(const std::string &waveform, double samp_rate, double pulse_width,
+                        double bandwidth, int code_length, int code_root, double prf,
+                        int zeropad);
+      ~waveform_src_impl();
+
+      bool start() override;
+
+      void init_meta_dict(const std::string &bandwidth_key,
+                          const std::string &duration_key,
+                          const std::string &sample_rate_key,
+                          const std::string &label_key,
+                          const std::string &prf_key) override;
+    };
+
+  } // namespace harmonia
+} // namespace gr
+
+#endif /* INCLUDED_HARMONIA_WAVEFORM_SRC_IMPL_H */
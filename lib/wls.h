@@ -0,0 +1,324 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Cody Kieu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_HARMONIA_WLS_H
+#define INCLUDED_HARMONIA_WLS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace gr
+{
+  namespace harmonia
+  {
+
+    /*
+     * Small dense weighted least-squares helpers, run on the host.
+     *
+     * The network solvers accumulate the normal equations A'WA x = A'Wy
+     * directly from a sparse list of rows (each measurement touches only a
+     * couple of nodes), so for N nodes the work is O(rows + N^3) with N^3
+     * tiny, and nothing is uploaded to the device.
+     */
+    class wls_normal
+    {
+    public:
+      explicit wls_normal(size_t n = 0) { reset(n); }
+
+      void reset(size_t n)
+      {
+        d_n = n;
+        d_M.assign(n * n, 0.0);
+        d_b.assign(n, 0.0);
+      }
+
+      size_t size() const { return d_n; }
+
+      // Add the row  sum_k a[k] x[col[k]] = y  with weight w
+      void add_row(const size_t *col, const double *a, size_t nnz, double y, double w)
+      {
+        for (size_t i = 0; i < nnz; i++)
+        {
+          d_b[col[i]] += w * a[i] * y;
+          for (size_t j = 0; j < nnz; j++)
+            d_M[col[i] * d_n + col[j]] += w * a[i] * a[j];
+        }
+      }
+
+      // Two-entry row, the common case for a (tx, rx) link
+      void add_row(size_t c0, double a0, size_t c1, double a1, double y, double w)
+      {
+        const size_t col[2] = {c0, c1};
+        const double a[2] = {a0, a1};
+        add_row(col, a, 2, y, w);
+      }
+
+      // Factor in place by Cholesky (M = L L'). Returns false if the system
+      // is not positive definite, i.e. the measurement graph leaves some
+      // node unconstrained.
+      bool factor()
+      {
+        const size_t n = d_n;
+        std::vector<double> &L = d_M;
+        for (size_t j = 0; j < n; j++)
+        {
+          double d = L[j * n + j];
+          for (size_t k = 0; k < j; k++)
+            d -= L[j * n + k] * L[j * n + k];
+          if (!(d > 0.0) || !std::isfinite(d))
+            return false;
+          d = std::sqrt(d);
+          L[j * n + j] = d;
+          for (size_t i = j + 1; i < n; i++)
+          {
+            double s = L[i * n + j];
+            for (size_t k = 0; k < j; k++)
+              s -= L[i * n + k] * L[j * n + k];
+            L[i * n + j] = s / d;
+          }
+        }
+        return true;
+      }
+
+      // Overwrite x with M^-1 x using the factor from factor(); lets one
+      // factorisation serve several right-hand sides
+      void substitute(std::vector<double> &x) const
+      {
+        const size_t n = d_n;
+        const std::vector<double> &L = d_M;
+
+        // Forward (L z = b) then back (L' x = z) substitution
+        for (size_t i = 0; i < n; i++)
+        {
+          for (size_t k = 0; k < i; k++)
+            x[i] -= L[i * n + k] * x[k];
+          x[i] /= L[i * n + i];
+        }
+        for (size_t i = n; i-- > 0;)
+        {
+          for (size_t k = i + 1; k < n; k++)
+            x[i] -= L[k * n + i] * x[k];
+          x[i] /= L[i * n + i];
+        }
+      }
+
+      // Factor and solve the accumulated system
+      bool solve(std::vector<double> &x)
+      {
+        if (!factor())
+          return false;
+        x = d_b;
+        substitute(x);
+        return true;
+      }
+
+    private:
+      size_t d_n;
+      std::vector<double> d_M; // row-major N x N, lower triangle holds L after factor()
+      std::vector<double> d_b;
+    };
+
+    /*
+     * One row of a sparse design with at most two entries, e.g. a (tx, rx)
+     * link or an anchor (a1 = 0).
+     */
+    struct wls_row
+    {
+      size_t c0;
+      double a0;
+      size_t c1;
+      double a1;
+
+      bool operator==(const wls_row &o) const
+      {
+        return c0 == o.c0 && a0 == o.a0 && c1 == o.c1 && a1 == o.a1;
+      }
+    };
+
+    /*
+     * Cached weighted pseudo-inverse P = (A'WA)^-1 A'W for a design that
+     * only depends on the network topology. update() rebuilds P only when
+     * the active rows or their weights differ from the cached ones, so an
+     * epoch on a fixed topology is a single mat-vec in apply().
+     */
+    class wls_pinv
+    {
+    public:
+      wls_pinv() : d_n(0), d_valid(false) {}
+
+      // Returns false if the system is singular. rebuilt (optional) is set
+      // when P had to be recomputed.
+      bool update(size_t n, const std::vector<wls_row> &rows, const std::vector<double> &w,
+                  bool *rebuilt = nullptr)
+      {
+        if (rebuilt)
+          *rebuilt = false;
+        if (n == d_n && rows == d_rows && w == d_w)
+          return d_valid;
+
+        d_n = n;
+        d_rows = rows;
+        d_w = w;
+        d_valid = false;
+        if (rebuilt)
+          *rebuilt = true;
+
+        wls_normal normal(n);
+        for (size_t r = 0; r < rows.size(); r++)
+          normal.add_row(rows[r].c0, rows[r].a0, rows[r].c1, rows[r].a1, 0.0, w[r]);
+        if (!normal.factor())
+          return false;
+
+        // Column r of P is M^-1 a_r w_r, stored contiguously per row
+        d_P.assign(n * rows.size(), 0.0);
+        std::vector<double> col(n);
+        for (size_t r = 0; r < rows.size(); r++)
+        {
+          std::fill(col.begin(), col.end(), 0.0);
+          col[rows[r].c0] += rows[r].a0 * w[r];
+          col[rows[r].c1] += rows[r].a1 * w[r];
+          normal.substitute(col);
+          std::copy(col.begin(), col.end(), d_P.begin() + r * n);
+        }
+        d_valid = true;
+        return true;
+      }
+
+      // x = P y, with y in the row order given to update()
+      void apply(const std::vector<double> &y, std::vector<double> &x) const
+      {
+        x.assign(d_n, 0.0);
+        for (size_t r = 0; r < d_rows.size(); r++)
+        {
+          const double *p = &d_P[r * d_n];
+          for (size_t k = 0; k < d_n; k++)
+            x[k] += p[k] * y[r];
+        }
+      }
+
+      const std::vector<wls_row> &rows() const { return d_rows; }
+
+    private:
+      size_t d_n;
+      std::vector<wls_row> d_rows;
+      std::vector<double> d_w;
+      std::vector<double> d_P; // n x rows, column per row
+      bool d_valid;
+    };
+
+    /*
+     * Robust M-estimation on top of a cached wls_pinv.
+     *
+     * Uses the pseudo-observation form of IRLS: instead of reweighting (and
+     * refactoring) A'WA each iteration, each observation is replaced by
+     * y* = A x + s psi(u) / sqrt(w) with u the standardised residual, and
+     * re-solved through the same pseudo-inverse. Only the first n_robust
+     * rows are reweighted (anchors/constraints come last). The scale s is
+     * the MAD of the standardised residuals, floored at scale_floor (1 when
+     * the weights are inverse CRLBs, 0 when they are only relative).
+     * Reports per-row residuals of the final fit and the effective
+     * weights psi(u) / u.
+     */
+    enum class robust_kind
+    {
+      NONE,
+      HUBER,
+      TUKEY
+    };
+
+    inline robust_kind robust_kind_from_string(const std::string &kind)
+    {
+      if (kind == "huber")
+        return robust_kind::HUBER;
+      if (kind == "tukey")
+        return robust_kind::TUKEY;
+      return robust_kind::NONE;
+    }
+
+    inline double robust_weight(robust_kind kind, double u, double k)
+    {
+      const double a = std::abs(u);
+      switch (kind)
+      {
+      case robust_kind::HUBER:
+        return a <= k ? 1.0 : k / a;
+      case robust_kind::TUKEY:
+      {
+        if (a >= k)
+          return 0.0;
+        const double t = 1.0 - (u / k) * (u / k);
+        return t * t;
+      }
+      default:
+        return 1.0;
+      }
+    }
+
+    inline void robust_solve(const wls_pinv &P, const std::vector<double> &w,
+                             const std::vector<double> &y, size_t n_robust,
+                             robust_kind kind, double k, std::vector<double> &x,
+                             std::vector<double> &resid, std::vector<double> &weight,
+                             double scale_floor = 1.0, int max_iter = 20, double tol = 1e-12)
+    {
+      const std::vector<wls_row> &rows = P.rows();
+      const size_t m = rows.size();
+      P.apply(y, x);
+      resid.assign(m, 0.0);
+      weight.assign(m, 1.0);
+
+      auto fit = [&](const std::vector<double> &xs, size_t r)
+      {
+        return rows[r].a0 * xs[rows[r].c0] + rows[r].a1 * xs[rows[r].c1];
+      };
+
+      std::vector<double> u(n_robust), au(n_robust), y_star(y);
+      for (int it = 0; kind != robust_kind::NONE && it < max_iter; it++)
+      {
+        for (size_t r = 0; r < n_robust; r++)
+        {
+          u[r] = (y[r] - fit(x, r)) * std::sqrt(w[r]);
+          au[r] = std::abs(u[r]);
+        }
+        double s = scale_floor;
+        if (n_robust > 0)
+        {
+          std::nth_element(au.begin(), au.begin() + n_robust / 2, au.end());
+          s = std::max(scale_floor, 1.4826 * au[n_robust / 2]);
+        }
+        if (!(s > 0.0))
+          break;
+
+        for (size_t r = 0; r < n_robust; r++)
+        {
+          weight[r] = robust_weight(kind, u[r] / s, k);
+          y_star[r] = fit(x, r) + weight[r] * u[r] / std::sqrt(w[r]);
+        }
+
+        std::vector<double> x_new;
+        P.apply(y_star, x_new);
+        double step = 0.0, norm = 0.0;
+        for (size_t i = 0; i < x.size(); i++)
+        {
+          step = std::max(step, std::abs(x_new[i] - x[i]));
+          norm = std::max(norm, std::abs(x_new[i]));
+        }
+        x.swap(x_new);
+        if (step <= tol * std::max(norm, 1.0))
+          break;
+      }
+
+      for (size_t r = 0; r < m; r++)
+        resid[r] = y[r] - fit(x, r);
+    }
+
+  } // namespace harmonia
+} // namespace gr
+
+#endif /* INCLUDED_HARMONIA_WLS_H */
@@ -16,7 +16,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0) */
 /* BINDTOOL_USE_PYGCCXML(0) */
 /* BINDTOOL_HEADER_FILE(LFM_src.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(ea17a3918d9425a611d2f41b33701a03) */
+/* BINDTOOL_HEADER_FILE_HASH(b0c99e9940fba5869da291610a282e5f) */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -46,5 +46,8 @@ void bind_LFM_src(py::module &m) {
            py::arg("duration_key"), py::arg("sample_rate_key"),
            py::arg("label_key"), py::arg("prf_key"), D(LFM_src, init_meta_dict))
 
+      .def("set_mf_spectrum", &LFM_src::set_mf_spectrum, py::arg("enable"),
+           D(LFM_src, set_mf_spectrum))
+
       ;
 }
@@ -16,7 +16,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0) */
 /* BINDTOOL_USE_PYGCCXML(0) */
 /* BINDTOOL_HEADER_FILE(clock_drift_est.h) */
-/* BINDTOOL_HEADER_FILE_HASH(94fb367b6141e4508e98f4b66803972c) */
+/* BINDTOOL_HEADER_FILE_HASH(a55ceddb021bffe96f6cc72a291e641b) */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -42,5 +42,9 @@ void bind_clock_drift_est(py::module &m) {
            py::arg("samp_rate"), py::arg("pulse_width"), py::arg("SNR"),
            D(clock_drift_est, make))
 
+      .def("set_robust_estimator", &clock_drift_est::set_robust_estimator,
+           py::arg("kind"), py::arg("tuning"),
+           D(clock_drift_est, set_robust_estimator))
+
       ;
 }
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2025 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually
+ * edited  */
+/* The following lines can be configured to regenerate this file during cmake */
+/* If manual edits are made, the following tags should be modified accordingly.
+ */
+/* BINDTOOL_GEN_AUTOMATIC(0) */
+/* BINDTOOL_USE_PYGCCXML(0) */
+/* BINDTOOL_HEADER_FILE(clock_state_tracker.h) */
+/* BINDTOOL_HEADER_FILE_HASH(ee4ea8ba15af5816958315c9d549002e) */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/harmonia/clock_state_tracker.h>
+// pydoc.h is automatically generated in the build directory
+#include <clock_state_tracker_pydoc.h>
+
+void bind_clock_state_tracker(py::module &m) {
+
+  using clock_state_tracker = ::gr::harmonia::clock_state_tracker;
+
+  py::class_<clock_state_tracker, gr::block, gr::basic_block,
+             std::shared_ptr<clock_state_tracker>>(m, "clock_state_tracker",
+                                                   D(clock_state_tracker))
+
+      .def(py::init(&clock_state_tracker::make), py::arg("num_platforms"),
+           py::arg("center_freq"), py::arg("q_bias"), py::arg("q_drift"),
+           py::arg("q_phase"), py::arg("r_bias"), py::arg("r_drift"),
+           py::arg("r_phase"), D(clock_state_tracker, make))
+
+      .def("reset", &clock_state_tracker::reset,
+           D(clock_state_tracker, reset))
+
+      ;
+}
@@ -16,7 +16,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0) */
 /* BINDTOOL_USE_PYGCCXML(0) */
 /* BINDTOOL_HEADER_FILE(clockbias_phase_est.h) */
-/* BINDTOOL_HEADER_FILE_HASH(336b2599637cc0dd946b37b998fcb5f9) */
+/* BINDTOOL_HEADER_FILE_HASH(7b479c5d0930038e7a162b452c28619f) */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -42,5 +42,9 @@ void bind_clockbias_phase_est(py::module &m) {
            py::arg("SNR"), py::arg("bias_status"), py::arg("phase_status"),
            D(clockbias_phase_est, make))
 
+      .def("set_robust_estimator", &clockbias_phase_est::set_robust_estimator,
+           py::arg("kind"), py::arg("tuning"),
+           D(clockbias_phase_est, set_robust_estimator))
+
       ;
 }
@@ -16,7 +16,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0) */
 /* BINDTOOL_USE_PYGCCXML(0) */
 /* BINDTOOL_HEADER_FILE(compensation.h) */
-/* BINDTOOL_HEADER_FILE_HASH(f3e529725db546e4b981117752709338) */
+/* BINDTOOL_HEADER_FILE_HASH(46a81a7aa5d42b2febae67ced22d81aa) */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -39,5 +39,9 @@ void bind_compensation(py::module &m) {
       .def(py::init(&compensation::make), py::arg("center_freq"),
            py::arg("samp_rate"), py::arg("sdr_id"), D(compensation, make))
 
+      .def("set_delay_method", &compensation::set_delay_method,
+           py::arg("method"), py::arg("taps"),
+           D(compensation, set_delay_method))
+
       ;
 }
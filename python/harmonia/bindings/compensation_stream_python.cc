@@ -0,0 +1,48 @@
+/*
+ * Copyright 2025 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually
+ * edited  */
+/* The following lines can be configured to regenerate this file during cmake */
+/* If manual edits are made, the following tags should be modified accordingly.
+ */
+/* BINDTOOL_GEN_AUTOMATIC(0) */
+/* BINDTOOL_USE_PYGCCXML(0) */
+/* BINDTOOL_HEADER_FILE(compensation_stream.h) */
+/* BINDTOOL_HEADER_FILE_HASH(0ff7bad2e32406bd0d32582485f2102a) */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/harmonia/compensation_stream.h>
+// pydoc.h is automatically generated in the build directory
+#include <compensation_stream_pydoc.h>
+
+void bind_compensation_stream(py::module &m) {
+
+  using compensation_stream = ::gr::harmonia::compensation_stream;
+
+  py::class_<compensation_stream, gr::sync_block, gr::block, gr::basic_block,
+             std::shared_ptr<compensation_stream>>(m, "compensation_stream",
+                                                   D(compensation_stream))
+
+      .def(py::init(&compensation_stream::make), py::arg("center_freq"),
+           py::arg("samp_rate"), py::arg("sdr_id"), py::arg("taps"),
+           py::arg("max_delay"), D(compensation_stream, make))
+
+      .def("set_delay", &compensation_stream::set_delay, py::arg("t_delay"),
+           D(compensation_stream, set_delay))
+
+      ;
+}
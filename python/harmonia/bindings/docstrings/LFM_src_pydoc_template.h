@@ -23,3 +23,5 @@ static const char *__doc_gr_harmonia_LFM_src_LFM_src_1 = R"doc()doc";
 static const char *__doc_gr_harmonia_LFM_src_make = R"doc()doc";
 
 static const char *__doc_gr_harmonia_LFM_src_init_meta_dict = R"doc()doc";
+
+static const char *__doc_gr_harmonia_LFM_src_set_mf_spectrum = R"doc()doc";
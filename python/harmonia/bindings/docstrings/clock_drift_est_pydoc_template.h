@@ -20,3 +20,6 @@ static const char *__doc_gr_harmonia_clock_drift_est_clock_drift_est_0 =
     R"doc()doc";
 
 static const char *__doc_gr_harmonia_clock_drift_est_make = R"doc()doc";
+
+static const char *__doc_gr_harmonia_clock_drift_est_set_robust_estimator =
+    R"doc()doc";
@@ -20,3 +20,6 @@ static const char *__doc_gr_harmonia_clockbias_phase_est_clockbias_phase_est_0 =
     R"doc()doc";
 
 static const char *__doc_gr_harmonia_clockbias_phase_est_make = R"doc()doc";
+
+static const char *__doc_gr_harmonia_clockbias_phase_est_set_robust_estimator =
+    R"doc()doc";
@@ -19,3 +19,6 @@ static const char *__doc_gr_harmonia_compensation = R"doc()doc";
 static const char *__doc_gr_harmonia_compensation_compensation_0 = R"doc()doc";
 
 static const char *__doc_gr_harmonia_compensation_make = R"doc()doc";
+
+static const char *__doc_gr_harmonia_compensation_set_delay_method =
+    R"doc()doc";
@@ -0,0 +1,25 @@
+/*
+ * Copyright 2025 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#include "pydoc_macros.h"
+#define D(...) DOC(gr, harmonia, __VA_ARGS__)
+/*
+  This file contains placeholders for docstrings for the Python bindings.
+  Do not edit! These were automatically extracted during the binding process
+  and will be overwritten during the build process
+ */
+
+static const char *__doc_gr_harmonia_compensation_stream = R"doc()doc";
+
+static const char *__doc_gr_harmonia_compensation_stream_compensation_stream_0 =
+    R"doc()doc";
+
+static const char *__doc_gr_harmonia_compensation_stream_make = R"doc()doc";
+
+static const char *__doc_gr_harmonia_compensation_stream_set_delay =
+    R"doc()doc";
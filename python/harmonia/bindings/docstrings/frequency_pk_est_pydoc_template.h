@@ -27,4 +27,10 @@ static const char *__doc_gr_harmonia_frequency_pk_est_make = R"doc()doc";
 static const char *__doc_gr_harmonia_frequency_pk_est_set_msg_queue_depth =
     R"doc()doc";
 
+static const char *__doc_gr_harmonia_frequency_pk_est_set_fdma_tones =
+    R"doc()doc";
+
+static const char *__doc_gr_harmonia_frequency_pk_est_set_pulse_integration =
+    R"doc()doc";
+
 static const char *__doc_gr_harmonia_frequency_pk_est_set_backend = R"doc()doc";
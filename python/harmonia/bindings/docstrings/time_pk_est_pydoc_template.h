@@ -25,4 +25,9 @@ static const char *__doc_gr_harmonia_time_pk_est_make = R"doc()doc";
 static const char *__doc_gr_harmonia_time_pk_est_set_msg_queue_depth =
     R"doc()doc";
 
+static const char *__doc_gr_harmonia_time_pk_est_set_tdma_schedule =
+    R"doc()doc";
+
+static const char *__doc_gr_harmonia_time_pk_est_set_cfar = R"doc()doc";
+
 static const char *__doc_gr_harmonia_time_pk_est_set_backend = R"doc()doc";
@@ -26,3 +26,6 @@ static const char *__doc_gr_harmonia_usrp_radar_all_make = R"doc()doc";
 
 static const char *__doc_gr_harmonia_usrp_radar_all_set_metadata_keys =
     R"doc()doc";
+
+static const char *__doc_gr_harmonia_usrp_radar_all_set_delay_method =
+    R"doc()doc";
@@ -0,0 +1,27 @@
+/*
+ * Copyright 2025 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#include "pydoc_macros.h"
+#define D(...) DOC(gr, harmonia, __VA_ARGS__)
+/*
+  This file contains placeholders for docstrings for the Python bindings.
+  Do not edit! These were automatically extracted during the binding process
+  and will be overwritten during the build process
+ */
+
+static const char *__doc_gr_harmonia_usrp_radar_net = R"doc()doc";
+
+static const char *__doc_gr_harmonia_usrp_radar_net_usrp_radar_net_0 =
+    R"doc()doc";
+
+static const char *__doc_gr_harmonia_usrp_radar_net_make = R"doc()doc";
+
+static const char *__doc_gr_harmonia_usrp_radar_net_set_delay_method =
+    R"doc()doc";
+
+static const char *__doc_gr_harmonia_usrp_radar_net_num_nodes = R"doc()doc";
@@ -20,3 +20,6 @@ static const char *__doc_gr_harmonia_usrp_radar_tdma_usrp_radar_tdma_0 =
     R"doc()doc";
 
 static const char *__doc_gr_harmonia_usrp_radar_tdma_make = R"doc()doc";
+
+static const char *__doc_gr_harmonia_usrp_radar_tdma_set_delay_method =
+    R"doc()doc";
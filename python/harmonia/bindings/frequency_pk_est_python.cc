@@ -16,7 +16,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0) */
 /* BINDTOOL_USE_PYGCCXML(0) */
 /* BINDTOOL_HEADER_FILE(frequency_pk_est.h) */
-/* BINDTOOL_HEADER_FILE_HASH(5c4717b6183d6efe4cfc954091170617) */
+/* BINDTOOL_HEADER_FILE_HASH(8e14e0d645aa9edabdabbc8bbc0eb940) */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -45,6 +45,13 @@ void bind_frequency_pk_est(py::module &m) {
       .def("set_msg_queue_depth", &frequency_pk_est::set_msg_queue_depth,
            py::arg("arg0"), D(frequency_pk_est, set_msg_queue_depth))
 
+      .def("set_fdma_tones", &frequency_pk_est::set_fdma_tones,
+           py::arg("tones"), D(frequency_pk_est, set_fdma_tones))
+
+      .def("set_pulse_integration", &frequency_pk_est::set_pulse_integration,
+           py::arg("num_pulses"), py::arg("coherent"),
+           D(frequency_pk_est, set_pulse_integration))
+
       .def("set_backend", &frequency_pk_est::set_backend, py::arg("arg0"),
            D(frequency_pk_est, set_backend))
 
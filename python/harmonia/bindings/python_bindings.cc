@@ -29,12 +29,16 @@ namespace py = pybind11;
     void bind_SDR_tagger(py::module& m);
     void bind_usrp_radar_all(py::module& m);
     void bind_clock_drift_est(py::module& m);
+    void bind_clock_state_tracker(py::module& m);
     void bind_time_pk_est(py::module& m);
     void bind_buffer_corrector(py::module& m);
     void bind_clockbias_phase_est(py::module& m);
     void bind_LFM_src(py::module& m);
+    void bind_waveform_src(py::module& m);
     void bind_compensation(py::module& m);
+    void bind_compensation_stream(py::module& m);
     void bind_usrp_radar_tdma(py::module& m);
+    void bind_usrp_radar_net(py::module& m);
 // ) END BINDING_FUNCTION_PROTOTYPES
 
 
@@ -71,11 +75,15 @@ PYBIND11_MODULE(harmonia_python, m)
     bind_SDR_tagger(m);
     bind_usrp_radar_all(m);
     bind_clock_drift_est(m);
+    bind_clock_state_tracker(m);
     bind_time_pk_est(m);
     bind_buffer_corrector(m);
     bind_clockbias_phase_est(m);
     bind_LFM_src(m);
+    bind_waveform_src(m);
     bind_compensation(m);
+    bind_compensation_stream(m);
     bind_usrp_radar_tdma(m);
+    bind_usrp_radar_net(m);
     // ) END BINDING_FUNCTION_CALLS
 }
\ No newline at end of file
@@ -16,7 +16,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0) */
 /* BINDTOOL_USE_PYGCCXML(0) */
 /* BINDTOOL_HEADER_FILE(time_pk_est.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(5190fdb7139000f9b26169700522e868) */
+/* BINDTOOL_HEADER_FILE_HASH(058aefa666f0ef77ecd95a52d8bec206) */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -44,6 +44,13 @@ void bind_time_pk_est(py::module &m) {
       .def("set_msg_queue_depth", &time_pk_est::set_msg_queue_depth,
            py::arg("depth"), D(time_pk_est, set_msg_queue_depth))
 
+      .def("set_tdma_schedule", &time_pk_est::set_tdma_schedule,
+           py::arg("slot_tx"), D(time_pk_est, set_tdma_schedule))
+
+      .def("set_cfar", &time_pk_est::set_cfar, py::arg("guard_cells"),
+           py::arg("train_cells"), py::arg("pfa"), py::arg("max_detections"),
+           D(time_pk_est, set_cfar))
+
       .def("set_backend", &time_pk_est::set_backend, py::arg("arg0"),
            D(time_pk_est, set_backend))
 
@@ -16,7 +16,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0) */
 /* BINDTOOL_USE_PYGCCXML(0) */
 /* BINDTOOL_HEADER_FILE(usrp_radar_all.h) */
-/* BINDTOOL_HEADER_FILE_HASH(e22a87828a952684653d855fc5189d0b) */
+/* BINDTOOL_HEADER_FILE_HASH(c1f25e9f58846f705b9738ae12b033b6) */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -52,5 +52,9 @@ void bind_usrp_radar_all(py::module &m) {
            py::arg("sample_start_key"), py::arg("prf_key"),
            D(usrp_radar_all, set_metadata_keys))
 
+      .def("set_delay_method", &usrp_radar_all::set_delay_method,
+           py::arg("method"), py::arg("taps"),
+           D(usrp_radar_all, set_delay_method))
+
       ;
 }
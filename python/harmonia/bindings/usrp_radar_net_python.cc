@@ -0,0 +1,51 @@
+/*
+ * Copyright 2025 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually
+ * edited  */
+/* The following lines can be configured to regenerate this file during cmake */
+/* If manual edits are made, the following tags should be modified accordingly.
+ */
+/* BINDTOOL_GEN_AUTOMATIC(0) */
+/* BINDTOOL_USE_PYGCCXML(0) */
+/* BINDTOOL_HEADER_FILE(usrp_radar_net.h) */
+/* BINDTOOL_HEADER_FILE_HASH(b453b4e3dbbd28845f81d15295dbcf44) */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/harmonia/usrp_radar_net.h>
+// pydoc.h is automatically generated in the build directory
+#include <usrp_radar_net_pydoc.h>
+
+void bind_usrp_radar_net(py::module &m) {
+
+  using usrp_radar_net = ::gr::harmonia::usrp_radar_net;
+
+  py::class_<usrp_radar_net, gr::block, gr::basic_block,
+             std::shared_ptr<usrp_radar_net>>(m, "usrp_radar_net",
+                                              D(usrp_radar_net))
+
+      .def(py::init(&usrp_radar_net::make), py::arg("config"),
+           D(usrp_radar_net, make))
+
+      .def("set_delay_method", &usrp_radar_net::set_delay_method,
+           py::arg("method"), py::arg("taps"),
+           D(usrp_radar_net, set_delay_method))
+
+      .def("num_nodes", &usrp_radar_net::num_nodes,
+           D(usrp_radar_net, num_nodes))
+
+      ;
+}
@@ -16,7 +16,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0) */
 /* BINDTOOL_USE_PYGCCXML(0) */
 /* BINDTOOL_HEADER_FILE(usrp_radar_tdma.h) */
-/* BINDTOOL_HEADER_FILE_HASH(8caa2e210d3cfd33fb82656ed6d35684) */
+/* BINDTOOL_HEADER_FILE_HASH(ad30525f70b817f3036d8cc6c1fbd444) */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -43,5 +43,9 @@ void bind_usrp_radar_tdma(py::module &m) {
            py::arg("cap_length2"), py::arg("wait_time"), py::arg("TDMA_time"),
            py::arg("TDMA_time2"), D(usrp_radar_tdma, make))
 
+      .def("set_delay_method", &usrp_radar_tdma::set_delay_method,
+           py::arg("method"), py::arg("taps"),
+           D(usrp_radar_tdma, set_delay_method))
+
       ;
 }
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2025 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually
+ * edited  */
+/* The following lines can be configured to regenerate this file during cmake */
+/* If manual edits are made, the following tags should be modified accordingly.
+ */
+/* BINDTOOL_GEN_AUTOMATIC(0) */
+/* BINDTOOL_USE_PYGCCXML(0) */
+/* BINDTOOL_HEADER_FILE(waveform_src.h) */
+/* BINDTOOL_HEADER_FILE_HASH(e027dc16b0e7ef29fae83fb7804298bf) */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/harmonia/waveform_src.h>
+// pydoc.h is automatically generated in the build directory
+#include <waveform_src_pydoc.h>
+
+void bind_waveform_src(py::module &m) {
+
+  using waveform_src = ::gr::harmonia::waveform_src;
+
+  py::class_<waveform_src, gr::block, gr::basic_block,
+             std::shared_ptr<waveform_src>>(m, "waveform_src", D(waveform_src))
+
+      .def(py::init(&waveform_src::make), py::arg("waveform"),
+           py::arg("samp_rate"), py::arg("pulse_width"), py::arg("bandwidth"),
+           py::arg("code_length"), py::arg("code_root"), py::arg("prf"),
+           py::arg("zeropad"), D(waveform_src, make))
+
+      .def("init_meta_dict", &waveform_src::init_meta_dict,
+           py::arg("bandwidth_key"), py::arg("duration_key"),
+           py::arg("sample_rate_key"), py::arg("label_key"),
+           py::arg("prf_key"), D(waveform_src, init_meta_dict))
+
+      ;
+}
@@ -0,0 +1,138 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2025 Cody Kieu.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import math
+import time
+
+import numpy as np
+import pmt
+from gnuradio import gr, gr_unittest, blocks
+try:
+    from gnuradio.harmonia import clock_state_tracker
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from gnuradio.harmonia import clock_state_tracker
+
+FC = 1e3
+Q = np.array([1e-12, 1e-14, 1e-3])
+R = np.array([1e-10, 1e-12, 1e-2])
+# Diffuse prior of the tracker: [bias, drift, phase]
+P0 = np.diag([1.0, 1e-8, math.pi ** 2])
+
+
+def kf_predict(x, P, dt):
+    w = 2 * math.pi * FC * dt
+    F = np.array([[1.0, dt, 0.0],
+                  [0.0, 1.0, 0.0],
+                  [0.0, w, 1.0]])
+    x = F @ x
+    x[2] = math.remainder(x[2], 2 * math.pi)
+    return x, F @ P @ F.T + np.diag(Q * dt)
+
+
+def kf_update(x, P, i, z):
+    K = P[:, i] / (P[i, i] + R[i])
+    x = x + K * (z - x[i])
+    return x, P - np.outer(K, P[i, :])
+
+
+class qa_clock_state_tracker(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+        self.tracker = clock_state_tracker(2, FC, *Q, *R)
+        self.dbg = blocks.message_debug()
+        self.tb.msg_connect((self.tracker, "out"), (self.dbg, "store"))
+
+    def tearDown(self):
+        self.tb = None
+
+    def run_messages(self, msgs):
+        # Post (port, dict) pairs one at a time, each answered by one output
+        self.tb.start()
+        for port, d in msgs:
+            meta = pmt.make_dict()
+            for key, val in d.items():
+                meta = pmt.dict_add(meta, pmt.intern(key), pmt.from_double(val))
+            count = self.dbg.num_messages()
+            self.tracker._post(pmt.intern(port), meta)
+            for _ in range(100):
+                if self.dbg.num_messages() > count:
+                    break
+                time.sleep(0.02)
+        self.tb.stop()
+        self.tb.wait()
+        self.assertEqual(self.dbg.num_messages(), len(msgs))
+        return [self.dbg.get_message(k) for k in range(len(msgs))]
+
+    def state(self, meta, k=1):
+        ref = lambda key: pmt.dict_ref(meta, pmt.intern(key + str(k)), pmt.PMT_NIL)
+        x = np.array([pmt.to_double(ref("cb_sdr")),
+                      pmt.to_double(ref("sdr")) - 1.0,
+                      pmt.to_double(ref("cp_tx_sdr"))])
+        return x, np.array(pmt.f64vector_elements(ref("state_var_sdr")))
+
+    def assertState(self, meta, x, P, k=1):
+        got_x, got_var = self.state(meta, k)
+        np.testing.assert_allclose(got_x, x, rtol=1e-9, atol=1e-15)
+        np.testing.assert_allclose(got_var, np.diag(P), rtol=1e-9, atol=1e-24)
+
+    def test_001_update_gain(self):
+        # One drift measurement moves the state by K = P / (P + r) of the
+        # innovation, in drift and in nothing else (P0 is diagonal)
+        out = self.run_messages([("in", {"epoch_time": 0.0, "sdr1": 1.0 + 2e-6})])
+        x, P = kf_update(np.zeros(3), P0, 1, 2e-6)
+        self.assertAlmostEqual(x[1], 2e-6 * 1e-8 / (1e-8 + R[1]), delta=1e-18)
+        self.assertState(out[0], x, P)
+        # The platform without a measurement keeps its prior
+        self.assertState(out[0], np.zeros(3), P0, k=2)
+
+    def test_002_predict_integrates_drift(self):
+        out = self.run_messages([
+            ("in", {"epoch_time": 0.0, "sdr1": 1.0 + 2e-6, "cb_sdr1": 1e-6}),
+            ("predict", {"epoch_time": 3.0}),
+        ])
+        x, P = kf_update(np.zeros(3), P0, 1, 2e-6)
+        x, P = kf_update(x, P, 0, 1e-6)
+        x_pred, P_pred = kf_predict(x, P, 3.0)
+
+        # Bias integrates drift and phase advances at 2 pi fc drift
+        self.assertAlmostEqual(x_pred[0], x[0] + 3.0 * x[1], delta=1e-15)
+        self.assertAlmostEqual(x_pred[2],
+                               math.remainder(x[2] + 2 * math.pi * FC * 3.0 * x[1], 2 * math.pi),
+                               delta=1e-12)
+        self.assertTrue(np.all(np.diag(P_pred) > np.diag(P)))
+        self.assertState(out[1], x_pred, P_pred)
+        self.assertTrue(pmt.to_bool(pmt.dict_ref(out[1], pmt.intern("clock_state_predicted"),
+                                                 pmt.PMT_F)))
+
+    def test_003_predict_leaves_state(self):
+        # A prediction publishes without moving the filter: a second one
+        # at the last update's epoch returns the updated state unchanged,
+        # and the next update propagates from that epoch
+        out = self.run_messages([
+            ("in", {"epoch_time": 1.0, "sdr1": 1.0 + 2e-6}),
+            ("predict", {"epoch_time": 5.0}),
+            ("predict", {"epoch_time": 1.0}),
+            ("in", {"epoch_time": 2.0, "cb_sdr1": 3e-6}),
+        ])
+        x, P = kf_update(np.zeros(3), P0, 1, 2e-6)
+        self.assertState(out[2], x, P)
+        self.assertFalse(pmt.to_bool(pmt.dict_ref(out[0], pmt.intern("clock_state_predicted"),
+                                                  pmt.PMT_T)))
+
+        x, P = kf_predict(x, P, 1.0)
+        x, P = kf_update(x, P, 0, 3e-6)
+        self.assertState(out[3], x, P)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_clock_state_tracker)
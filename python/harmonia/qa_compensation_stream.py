@@ -0,0 +1,118 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2025 Cody Kieu.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import math
+
+import numpy as np
+import pmt
+from gnuradio import gr, gr_unittest, blocks
+try:
+    from gnuradio.harmonia import compensation_stream
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from gnuradio.harmonia import compensation_stream
+
+FC = 1e9
+FS = 1e6
+TAPS = 8
+MAX_DELAY = 4
+# Fixed output latency: max_delay + taps / 2
+LATENCY = MAX_DELAY + TAPS // 2
+
+
+def drift_inc(alpha):
+    # Drift phase per sample, 2 pi fc (alpha - 1) / (alpha fs)
+    return 2 * math.pi * FC * (alpha - 1.0) / (alpha * FS)
+
+
+def estimate(key, value):
+    return pmt.dict_add(pmt.make_dict(), pmt.intern(key), pmt.from_double(value))
+
+
+class qa_compensation_stream(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+        self.comp = compensation_stream(FC, FS, 1, TAPS, MAX_DELAY)
+        # Small buffers so every run spans many work() calls
+        self.comp.set_max_noutput_items(64)
+        self.sink = blocks.vector_sink_c()
+
+    def tearDown(self):
+        self.tb = None
+
+    def connect(self, data, tags=()):
+        self.src = blocks.vector_source_c(data, False, 1, list(tags))
+        self.tb.connect(self.src, self.comp, self.sink)
+
+    def assertPhase(self, out, phase):
+        # Unit input: the output is exp(j phase) once past the latency
+        want = np.exp(1j * np.asarray(phase))
+        np.testing.assert_allclose(out[LATENCY:], want[LATENCY:], atol=1e-4)
+
+    def test_001_drift_ramp_is_continuous(self):
+        n = 2048
+        alpha = 1.0 + 1e-7
+        self.comp._post(pmt.intern("cd_in"), estimate("sdr1", alpha))
+        self.connect([1 + 0j] * n)
+        self.tb.run()
+
+        out = np.array(self.sink.data())
+        self.assertEqual(len(out), n)
+        self.assertPhase(out, drift_inc(alpha) * np.arange(n))
+
+    def test_002_estimates_take_effect_without_a_jump(self):
+        n = 1024
+        alpha1, alpha2, gamma = 1.0 + 1e-7, 1.0 - 2e-7, 0.5
+        self.comp._post(pmt.intern("cd_in"), estimate("sdr1", alpha1))
+        self.connect([1 + 0j] * n)
+        self.tb.run()
+
+        # New drift and carrier phase between runs: the ramp carries on
+        # from where it stopped, plus only the new constant term
+        self.comp._post(pmt.intern("cd_in"), estimate("sdr1", alpha2))
+        self.comp._post(pmt.intern("cp_in"), estimate("cp_rx_sdr1", gamma))
+        self.src.rewind()
+        self.tb.run()
+
+        out = np.array(self.sink.data())
+        self.assertEqual(len(out), 2 * n)
+        self.assertPhase(out[:n], drift_inc(alpha1) * np.arange(n))
+        self.assertPhase(out[n:], drift_inc(alpha1) * n + gamma + drift_inc(alpha2) * np.arange(n))
+
+    def test_003_rx_error_tag_delays_from_the_tag(self):
+        # Impulses before and after an rx_error tag: the first keeps the
+        # zero delay, the later ones move by -t_delay * fs on top of the
+        # latency. A negative rx_error is a delay, a positive one an advance.
+        for t_delay, shift in ((-3.0 / FS, 3), (2.0 / FS, -2)):
+            self.tb = gr.top_block()
+            self.comp = compensation_stream(FC, FS, 1, TAPS, MAX_DELAY)
+            self.sink = blocks.vector_sink_c()
+
+            x = np.zeros(256, dtype=np.complex64)
+            x[20] = 1.0
+            x[100] = 1.0
+            tag = gr.tag_t()
+            tag.offset = 50
+            tag.key = pmt.intern("rx_error")
+            tag.value = pmt.from_double(t_delay)
+            self.connect(x.tolist(), [tag])
+            self.tb.run()
+
+            out = np.array(self.sink.data())
+            want = np.zeros(256)
+            want[20 + LATENCY] = 1.0
+            want[100 + LATENCY + shift] = 1.0
+            np.testing.assert_allclose(np.abs(out), want, atol=1e-5)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_compensation_stream)
@@ -6,8 +6,11 @@
 # SPDX-License-Identifier: GPL-3.0-or-later
 #
 
-from gnuradio import gr, gr_unittest
-# from gnuradio import blocks
+import math
+import time
+
+import pmt
+from gnuradio import gr, gr_unittest, blocks
 try:
     from gnuradio.harmonia import time_pk_est
 except ImportError:
@@ -25,14 +28,53 @@ class qa_time_pk_est(gr_unittest.TestCase):
     def tearDown(self):
         self.tb = None
 
-    def test_instance(self):
-        # FIXME: Test will fail until you pass sensible arguments to the constructor
-        instance = time_pk_est()
+    def estimate(self, est, tx, rx):
+        # Push one reference and one capture through the block and return
+        # the metadata of the tp_out PDU
+        dbg = blocks.message_debug()
+        self.tb.msg_connect((est, "tp_out"), (dbg, "store"))
+        self.tb.start()
+        est._post(pmt.intern("tx"), pmt.cons(pmt.make_dict(), pmt.init_c32vector(len(tx), tx)))
+        time.sleep(0.1)
+        est._post(pmt.intern("rx"), pmt.cons(pmt.make_dict(), pmt.init_c32vector(len(rx), rx)))
+        for _ in range(100):
+            if dbg.num_messages() > 0:
+                break
+            time.sleep(0.05)
+        self.tb.stop()
+        self.tb.wait()
+        self.assertEqual(dbg.num_messages(), 1)
+        return pmt.car(dbg.get_message(0))
+
+    def test_001_cfar_short_response(self):
+        # A response of 11 lags, shorter than 2 (G + T) = 28: no lag has a
+        # training cell, so the count is floored at one and the peak is
+        # still detected instead of the threshold turning NaN
+        est = time_pk_est(1e6, 1e6, 0.0, 0.0, 10, 1, False)
+        est.set_msg_queue_depth(10)
+        est.set_tdma_schedule([2, 1])
+        est.set_cfar(10, 4, 1e-6, 4)
+
+        tx = [1 + 0j] * 3
+        rx = [0j] * 12
+        rx[4:7] = tx
+        meta = self.estimate(est, tx, rx)
+
+        self.assertTrue(pmt.dict_has_key(meta, pmt.intern("cfar_sdr2")))
+        cfar = pmt.f64vector_elements(pmt.dict_ref(meta, pmt.intern("cfar_sdr2"), pmt.PMT_NIL))
+        t = pmt.f64vector_elements(pmt.dict_ref(meta, pmt.intern("sdr2"), pmt.PMT_NIL))
+        self.assertEqual(len(cfar), 1)
+        self.assertTrue(math.isfinite(cfar[0]))
+        # The only detection is the strongest peak
+        self.assertAlmostEqual(cfar[0], t[0], places=9)
 
-    def test_001_descriptive_test_name(self):
-        # set up fg
-        self.tb.run()
-        # check data
+        # Too few lags outside the mainlobe for a noise floor: the quality
+        # keys are still published, with NaN entries
+        for key in ("snr_sdr2", "pslr_sdr2", "var_sdr2"):
+            self.assertTrue(pmt.dict_has_key(meta, pmt.intern(key)))
+            v = pmt.f64vector_elements(pmt.dict_ref(meta, pmt.intern(key), pmt.PMT_NIL))
+            self.assertEqual(len(v), 1)
+            self.assertTrue(math.isnan(v[0]))
 
 
 if __name__ == '__main__':
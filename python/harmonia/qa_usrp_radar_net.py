@@ -0,0 +1,46 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2025 Cody Kieu.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import os
+import unittest
+
+from gnuradio import gr, gr_unittest
+try:
+    from gnuradio.harmonia import usrp_radar_net
+except ImportError:
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from gnuradio.harmonia import usrp_radar_net
+
+class qa_usrp_radar_net(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_001_rejects_malformed_description(self):
+        # The description is parsed before any radio is opened
+        for config in ['{"nodes": []}',
+                       '{"nodes": [{"args": ""}]}',
+                       '{"nodes": ',
+                       '/nonexistent/usrp_radar_net.json']:
+            with self.assertRaises(ValueError):
+                usrp_radar_net(config)
+
+    @unittest.skipUnless(os.environ.get("HARMONIA_USRP_NET_CONFIG"),
+                         "set HARMONIA_USRP_NET_CONFIG to a network description to test with radios")
+    def test_002_instance(self):
+        instance = usrp_radar_net(os.environ["HARMONIA_USRP_NET_CONFIG"])
+        self.assertGreater(instance.num_nodes(), 0)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_usrp_radar_net)
@@ -0,0 +1,99 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2025 Cody Kieu.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import time
+
+import numpy as np
+import pmt
+from gnuradio import gr, gr_unittest, blocks
+try:
+    from gnuradio.harmonia import waveform_src
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from gnuradio.harmonia import waveform_src
+
+FS = 1e6
+
+
+class qa_waveform_src(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def pulse(self, waveform, chips, spc=1, root=1, zeropad=0):
+        # The PDU the block publishes at start: (samples, metadata)
+        src = waveform_src(waveform, FS, chips * spc / FS, FS / 4, chips, root, 0.0, zeropad)
+        dbg = blocks.message_debug()
+        self.tb.msg_connect((src, "out"), (dbg, "store"))
+        self.tb.start()
+        for _ in range(100):
+            if dbg.num_messages() > 0:
+                break
+            time.sleep(0.02)
+        self.tb.stop()
+        self.tb.wait()
+        self.assertGreaterEqual(dbg.num_messages(), 1)
+        msg = dbg.get_message(0)
+        return np.array(pmt.c32vector_elements(pmt.cdr(msg))), pmt.car(msg)
+
+    def test_001_barker_sidelobes(self):
+        x, _ = self.pulse("barker", 13)
+        self.assertEqual(len(x), 13)
+        r = np.abs(np.correlate(x, x, "full"))
+        peak = r[len(x) - 1]
+        sidelobes = np.delete(r, len(x) - 1)
+        self.assertAlmostEqual(peak, 13.0, places=4)
+        self.assertLessEqual(sidelobes.max() / peak, 1.0 / 13 + 1e-6)
+
+    def test_002_zadoff_chu_cazac(self):
+        x, _ = self.pulse("zadoff_chu", 63, root=5)
+        np.testing.assert_allclose(np.abs(x), 1.0, atol=1e-6)
+        # Periodic autocorrelation vanishes at every nonzero lag
+        r = np.fft.ifft(np.abs(np.fft.fft(x)) ** 2)
+        self.assertAlmostEqual(abs(r[0]), 63.0, places=3)
+        self.assertLess(np.abs(r[1:]).max(), 1e-3)
+
+    def test_003_costas_permutation(self):
+        # Order 12 (13 prime), 32 samples per chip; the tone of each chip
+        # from its sample-to-sample phase step, in units of the hop spacing
+        chips, spc = 12, 32
+        x, _ = self.pulse("costas", chips, spc=spc)
+        self.assertEqual(len(x), chips * spc)
+        hops = []
+        for k in range(chips):
+            c = x[k * spc:(k + 1) * spc]
+            step = np.angle(np.mean(c[1:] * np.conj(c[:-1])))
+            hops.append(int(round(step * spc / (2 * np.pi) + (chips + 1) / 2.0)))
+        self.assertEqual(sorted(hops), list(range(1, chips + 1)))
+
+    def test_004_matched_filter_spectrum(self):
+        x, meta = self.pulse("barker", 13, spc=3, zeropad=10)
+        self.assertEqual(len(x), 13 * 3 + 10)
+
+        ref = lambda key: pmt.dict_ref(meta, pmt.intern(key), pmt.PMT_NIL)
+        H = np.array(pmt.c32vector_elements(ref("mf_spectrum")))
+        nfft = pmt.to_long(ref("mf_nfft"))
+        self.assertEqual(pmt.to_long(ref("mf_length")), len(x))
+        self.assertEqual(nfft, len(H))
+        # Next power of two >= 4 * length
+        self.assertEqual(nfft, 256)
+        np.testing.assert_allclose(H, np.fft.fft(np.conj(x[::-1]), nfft), atol=1e-4)
+
+    def test_005_unknown_waveform(self):
+        with self.assertRaises(ValueError):
+            waveform_src("chirp", FS, 13 / FS, FS / 4, 13, 1, 0.0, 0)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_waveform_src)